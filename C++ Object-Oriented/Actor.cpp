@@ -1,14 +1,28 @@
 #include "Actor.h"
 #include "StudentWorld.h"
-#include <queue>
 
 // obj constructor
 obj::obj(int hp, int imageID, int startX, int startY, StudentWorld* worldIn, Direction dir, double size, unsigned int depth)
-    : GraphObject(imageID, startX, startY, dir, size, depth)
 {
     world = worldIn; // saves a pointer to the StudentWorld it belongs to
 
     health = hp; // either ticks left for object to stay on field OR hit points left for TunnelMan/Protesters
+
+    // every obj starts awake and off any TimerWheel
+    link.order = -1;
+    link.sleepPass = 0;
+    link.wakePass = 0;
+    link.list = wheelLink::NONE;
+    link.index = 0;
+
+    // saves what the frontend needs to draw the object, which starts out invisible
+    this->imageID = imageID;
+    x = startX;
+    y = startY;
+    facing = dir;
+    this->size = size;
+    this->depth = depth;
+    visible = false;
 }
 
 // destructor
@@ -16,6 +30,89 @@ obj::~obj()
 {
 }
 
+// moves the object to (x, y) and tells StudentWorld so its spatial grid stays up to date
+void obj::moveTo(int x, int y)
+{
+    // remember where the object was so StudentWorld can find it in the grid
+    int oldX = getX();
+    int oldY = getY();
+
+    this->x = x;
+    this->y = y;
+
+    moved(oldX, oldY); // let the derived class refile itself if it is in a spatial grid
+}
+
+// returns x coordinate
+int obj::getX() const
+{
+    return x;
+}
+
+// returns y coordinate
+int obj::getY() const
+{
+    return y;
+}
+
+// returns direction obj is facing
+obj::Direction obj::getDirection() const
+{
+    return facing;
+}
+
+// turns obj to face dir
+void obj::setDirection(Direction dir)
+{
+    facing = dir;
+}
+
+// returns true if the frontend should draw obj
+bool obj::isVisible() const
+{
+    return visible;
+}
+
+// shows or hides obj
+void obj::setVisible(bool shouldDisplay)
+{
+    visible = shouldDisplay;
+}
+
+// returns the image ID, which also tells what kind of obj this is
+int obj::getID() const
+{
+    return imageID;
+}
+
+// returns how large the frontend draws obj
+double obj::getSize() const
+{
+    return size;
+}
+
+// returns how far back the frontend draws obj
+unsigned int obj::getDepth() const
+{
+    return depth;
+}
+
+// returns the obj's link on its TimerWheel
+wheelLink& obj::getWheelLink()
+{
+    return link;
+}
+
+// most objs never sleep, so there is nothing to wake
+void obj::hitPointsRanOut()
+{
+}
+
+// most objs are not filed in a spatial grid, so there is nothing to update
+void obj::moved(int, int)
+{
+}
+
 // returns true if object should still stay on field, false otherwise
 // overloaded only in the case of Boulder
 bool obj::getStatus()
@@ -33,6 +130,10 @@ StudentWorld* obj::getWorld()
 void obj::changeHitPoints(int change)
 {
     health += change;
+
+    // let the obj know it has run out, in case it is asleep
+    if (health <= 0)
+        hitPointsRanOut();
 }
 
 // returns ticks/hit points
@@ -41,51 +142,58 @@ int obj::getHitPoints()
     return health;
 }
 
-// creates a new Earth object at (x, y). health is set to -1 because Earth is handled differently than the other objects
-// in StudentWorld
-Earth::Earth(int x, int y, StudentWorld* worldIn)
-    : obj(-1, TID_EARTH, x, y, worldIn, GraphObject::right, 0.25, 3)
-{
-    setVisible(true); // make the Earth visible on spawning in
-}
-
-// destructor
-Earth::~Earth()
-{
-}
-
-// mandatory definition since is pure function in base class
-// does not do anything
-void Earth::doSomething()
+// objs that are not pooled were made with new, so they are deleted
+void obj::destroy()
 {
+    delete this;
 }
 
 // creates a nwe Boulder object at position (x, y)
 Boulder::Boulder(int x, int y, StudentWorld* worldIn)
-    : obj(30, TID_BOULDER, x, y, worldIn, GraphObject::down, 1, 1)
+    : obj(30, TID_BOULDER, x, y, worldIn, obj::down, 1, 1)
 {
     setVisible(true); // spawns in as visible
 
     status = "stable"; // spawns in as stable, since there is dirt underneath it
+
+    // watch the row under the Boulder, and check it on the first tick in case it spawned over a hole
+    supportChanged = true;
+    getWorld()->watchTerrain(this, x, y - 1, SPRITE_WIDTH, 1);
 }
 
-// destructor
+// destructor, stops watching the terrain if it still was
 Boulder::~Boulder()
 {
+    getWorld()->unwatchTerrain(this);
 }
 
 // called every tick during the game
 // tells Boulder object what to do
 void Boulder::doSomething()
 {
+    // take any ticks slept through off the wait before falling
+    changeHitPoints(-int(getWorld()->wake(this)));
+
     // if the Boulder object is already dead, do nothing
     if (!getStatus())
         return;
 
     // else if the Boulder is marked stable but there is no longer any dirt under it
-    // mark it as waiting to fall
-    if (!dirtUnder() && status == "stable")
-        status = "waiting";
+    // mark it as waiting to fall. the terrain under it is only checked if it changed since the last tick
+    if (status == "stable" && supportChanged) {
+        supportChanged = false;
+
+        if (!dirtUnder()) {
+            status = "waiting";
+            getWorld()->unwatchTerrain(this); // the Boulder will never be stable again
+        }
+    }
+
+    // a stable Boulder has nothing to do until the row under it changes, which wakes it
+    if (status == "stable") {
+        getWorld()->sleepFor(this, LONG_MAX);
+        return;
+    }
 
     // if the Boulder is waiting to fall
     if (status == "waiting") {
@@ -135,6 +243,10 @@ void Boulder::doSomething()
                 // play the Boulder falling sound
                 getWorld()->playSound(SOUND_FALLING_ROCK);
             }
+
+            // else every tick until the last one only counts down, so sleep through them
+            else
+                getWorld()->sleepFor(this, getHitPoints() - 1);
         }
     }
 }
@@ -145,6 +257,14 @@ bool Boulder::getStatus()
     return !(status == "dead"); // return if the status is not dead, aka if the Boulder is "alive"
 }
 
+// called by StudentWorld when cells in the row under the Boulder change
+void Boulder::terrainChanged(int, int, int, int)
+{
+    supportChanged = true;
+
+    getWorld()->wake(this); // a stable Boulder is not counting anything down, so there is nothing to catch up
+}
+
 // returns true if there is a dirt or boulder underneath this Boulder, else return false
 bool Boulder::dirtUnder()
 {
@@ -152,57 +272,32 @@ bool Boulder::dirtUnder()
     int x = getX();
     int y = getY() - 1;
 
-    // get pointer to the StudentWorld the Boulder belongs to
-    StudentWorld* temp = getWorld();
-
     // check the hash table in StudentWorld if there are any Boulders or Earth directly below this Boulder
-    for (int i = x; i < x + SPRITE_WIDTH; i++)
-        // if there is at least one pixel of Earth/Boulder underneat, return true
-        if (temp->getPixelArrID(i, y) == TID_EARTH || temp->getPixelArrID(i, y) == TID_BOULDER)
-            return true;
-
-    // if there is no Earth or Boulder under this Boulder, return false
-    return false;
+    return getWorld()->getTerrain().rowDirt(x, y, SPRITE_WIDTH);
 }
 
 // while Boulder is moving, check if it hits any TunnelMan/Protesters and deplete their hp
 void Boulder::checkMoveCollisions()
 {
-    std::list<obj*> actors = getWorld()->getActors(); // get list of actors in StudentWorld
-
-    // iterate through each obj in actors
-    std::list<obj*>::iterator it = actors.begin();
-    while (it != actors.end()) {
-        int itID = (*it)->getID(); // get the ID of the current actor
+    StudentWorld* world = getWorld(); // get a pointer to StudentWorld
+    TunnelMan* player = world->getPlayer(); // get a pointer to the TunnelMan
 
-        // if the obj is a player or protester
-        if (itID == TID_PLAYER || itID == TID_PROTESTER || itID == TID_HARD_CORE_PROTESTER) {
-            // calculate the distance between this Boulder and the actor
-            double dist = getWorld()->calcDist(getX(), getY(), (*it)->getX(), (*it)->getY());
+    // if the TunnelMan is within three units of this Boulder, deplete its hit points
+    if (world->calcDist(getX(), getY(), player->getX(), player->getY()) <= 3.0)
+        player->changeHitPoints(-100);
 
-            // if the distance is less than three
-            if (dist <= 3.0) {
-                // if the actor is not TunnelMan, then they must be a protester
-                if (itID != TID_PLAYER) {
-                    // downcast to use protester methods
-                    ProtesterTemplate* temp = dynamic_cast<ProtesterTemplate*>(*it);
+    // visit each protester within three units of this Boulder
+    world->forEachProtesterNear(getX(), getY(), 3, [&](ProtesterTemplate* protester) {
+        // if the protester is stunned, skip them
+        if (protester->getStunned())
+            return false;
 
-                    // if the protester is stunned, skip then
-                    if (temp->getStunned()) {
-                        it++;
-                        continue;
-                    }
+        // else if they are not stunned, increase the game's score and deplete their hit points
+        world->increaseScore(500);
+        protester->changeHitPoints(-100);
 
-                    // else if they are not stunned, increase the game's score
-                    getWorld()->increaseScore(500);
-                }
-
-                (*it)->changeHitPoints(-100); // deplete the actor's hit points
-            }
-        }
-
-        it++; // move onto the next obj in actors
-    }
+        return false; // keep looking for more protesters
+    });
 }
 
 // abstract base class for Goods type objects that TunnelMan can pick up
@@ -218,6 +313,18 @@ Goods::~Goods()
 {
 }
 
+// only GoldNugget overrides this to return true
+bool Goods::isGold()
+{
+    return false;
+}
+
+// moves this good to its new bucket in the spatial grid of goods
+void Goods::moved(int oldX, int oldY)
+{
+    getWorld()->goodsMoved(this, oldX, oldY);
+}
+
 // constructor for Barrel, a derived class from Goods
 // creates a Barrel object at (x, y). hp/ticks on field is set to 1, but the class will not decrement it
 // until TunnelMan picks up the barrel, so it stays indefinitely
@@ -265,7 +372,7 @@ void Barrel::doSomething()
 
 // constructor for Sonar objects that spawn in
 // creates a Sonar object at (x, y)
-// in StudentWorld, (x, y) is always (0, 60)
+// in StudentWorld, (x, y) is always the top left corner, (0, 60) in the game's own field
 Sonar::Sonar(int x, int y, StudentWorld* worldIn)
     : Goods(x, y, 1, TID_SONAR, worldIn)
 {
@@ -281,6 +388,12 @@ Sonar::~Sonar()
 {
 }
 
+// Sonars are made by StudentWorld's pool, so they go back to it
+void Sonar::destroy()
+{
+    getWorld()->recycle(this);
+}
+
 // tells the Sonar object what to do every tick
 // either the health of the Sonar object is depleted until it reaches 0 and is removed from field
 // or the TunnelMan picks it up
@@ -339,6 +452,18 @@ GoldNugget::~GoldNugget()
 {
 }
 
+// lets TunnelMan find dropped nuggets among the other goods
+bool GoldNugget::isGold()
+{
+    return true;
+}
+
+// GoldNuggets are made by StudentWorld's pool, so they go back to it
+void GoldNugget::destroy()
+{
+    getWorld()->recycle(this);
+}
+
 // tells GoldNugget what to do every tick, and depending on if Protesters or TunnelMan can pick it up
 void GoldNugget::doSomething()
 {
@@ -382,40 +507,20 @@ void GoldNugget::doSomething()
         int x = getX();
         int y = getY();
 
-        // get a list of objs in the game
-        std::list<obj*> actors = getWorld()->getActors();
-
-        // iterates through each obj in actors
-        std::list<obj*>::iterator it = actors.begin();
-        while (it != actors.end()) {
-            // if the current obj is a protester
-            if ((*it)->getID() == TID_PROTESTER || (*it)->getID() == TID_HARD_CORE_PROTESTER) {
-                // calculate the distance from the protester to this object
-                double dist = getWorld()->calcDist(x, y, (*it)->getX(), (*it)->getY());
-
-                // if the object is within 3 units of the current obj
-                if (dist <= 3.0) {
-                    // the current obj must be a protester, so downcast it to get the protester to react accordingly
-                    ProtesterTemplate* temp = dynamic_cast<ProtesterTemplate*>(*it);
-
-                    // if the protester is already stunned, do nothing
-                    if (temp->getStunned()) {
-                        it++;
-                        continue;
-                    }
-
-                    changeHitPoints(-100); // zero out this object's health to remove it from the field
+        // visit the protesters within three units of this object until one picks it up
+        getWorld()->forEachProtesterNear(x, y, 3, [&](ProtesterTemplate* protester) {
+            // if the protester is already stunned, do nothing
+            if (protester->getStunned())
+                return false;
 
-                    temp->gotGold();
+            changeHitPoints(-100); // zero out this object's health to remove it from the field
 
-                    temp->changeStunned(true);
+            protester->gotGold();
 
-                    return;
-                }
-            }
+            protester->changeStunned(true);
 
-            it++; // move onto the next obj in actors
-        }
+            return true; // the nugget was picked up, so stop looking
+        });
     }
 }
 
@@ -436,6 +541,12 @@ WaterPool::~WaterPool()
 {
 }
 
+// WaterPools are made by StudentWorld's pool, so they go back to it
+void WaterPool::destroy()
+{
+    getWorld()->recycle(this);
+}
+
 // tells the WaterPool object what to do every tick
 void WaterPool::doSomething()
 {
@@ -473,7 +584,7 @@ int WaterPool::calcTicks()
 }
 
 // creates a new Squirt object at (x, y) facing dir
-Squirt::Squirt(int x, int y, GraphObject::Direction dir, StudentWorld* worldIn)
+Squirt::Squirt(int x, int y, obj::Direction dir, StudentWorld* worldIn)
     : obj(5, TID_WATER_SPURT, x, y, worldIn, dir, 1, 1)
 {
     setVisible(true); // spawns in as visible
@@ -484,6 +595,12 @@ Squirt::~Squirt()
 {
 }
 
+// Squirts are made by StudentWorld's pool, so they go back to it
+void Squirt::destroy()
+{
+    getWorld()->recycle(this);
+}
+
 // tells Squirt what to do every tick
 void Squirt::doSomething()
 {
@@ -516,41 +633,35 @@ void Squirt::doSomething()
     }
     }
 
-    // get a pointer to StudentWorld
-    StudentWorld* temp = getWorld();
+    // get the bitboard layer of Earth and Boulders from StudentWorld
+    const Terrain& terrain = getWorld()->getTerrain();
 
     // if the area the Squirt is about to occupy has Earth or Boulder, zero out the Squirt's health to remove it from the field
     // if the Squirt hits a Protester, tell the Protester to react accordingly using checkCollisions
     // in both cases, immediately return
     int tempX = x;
     int tempY = y;
+    bool blocked = false;
     switch (move) {
     case up:
         tempY += 3;
     case down: {
-        for (int i = tempX; i < tempX + SPRITE_WIDTH; i++) {
-            int TID = temp->getPixelArrID(i, tempY);
-            if (checkMoveCollisions() || y > 60 || y < 0 || TID == TID_BOULDER || TID == TID_EARTH) {
-                changeHitPoints(-5);
-                return;
-            }
-        }
+        blocked = y > getWorld()->getMaxY() || y < 0 || terrain.rowDirt(tempX, tempY, SPRITE_WIDTH);
         break;
     }
     case right:
         tempX += 3;
     case left: {
-        for (int i = tempY; i < tempY + SPRITE_HEIGHT; i++) {
-            int TID = temp->getPixelArrID(tempX, i);
-            if (checkMoveCollisions() || x > 60 || x < 0 || TID == TID_BOULDER || TID == TID_EARTH) {
-                changeHitPoints(-5);
-                return;
-            }
-        }
+        blocked = x > getWorld()->getMaxX() || x < 0 || terrain.columnDirt(tempX, tempY, SPRITE_HEIGHT);
         break;
     }
     }
 
+    if (checkMoveCollisions() || blocked) {
+        changeHitPoints(-5);
+        return;
+    }
+
     // if the code reaches this point, the Squirt is still in play and moves one unit in the correct direction
     moveTo(x, y);
 
@@ -560,64 +671,37 @@ void Squirt::doSomething()
 // check if the Squirt collides with any Protesters
 bool Squirt::checkMoveCollisions()
 {
-    // get a list of objs in the game
-    std::list<obj*> actors = getWorld()->getActors();
-
-    // iterate through each obj in the game
-    std::list<obj*>::iterator it = actors.begin();
-    while (it != actors.end()) {
-        int itID = (*it)->getID(); // get the ID of the current obj
-
-        // if the ID is a Protester
-        if (itID == TID_PROTESTER || itID == TID_HARD_CORE_PROTESTER) {
-            // downcast the Protester obj
-            ProtesterTemplate* temp = dynamic_cast<ProtesterTemplate*>(*it);
-
-            // if this protester is already stunned, move onto the next item in the list
-            if (temp->getStunned()) {
-                it++;
-                continue;
-            }
-
-            // calculate the distance between the Squirt and the Protester
-            double dist = getWorld()->calcDist(getX(), getY(), (*it)->getX(), (*it)->getY());
-
-            // if the distance is <= 3
-            if (dist <= 3.0) {
-                // retrieve the obj's health before and after getting squirted
-                int currStat = (*it)->getHitPoints();
-                (*it)->changeHitPoints(-2);
-                int newStat = (*it)->getHitPoints();
-
-                // increase the score accordingly if the Protester's health reaches 0
-                if (currStat > 0 && newStat <= 0) {
-                    if (itID == TID_PROTESTER)
-                        getWorld()->increaseScore(100);
-                    else
-                        getWorld()->increaseScore(250);
-                }
-
-                // if the Protester is not dead, then stun it and make it sound annoyed
-                if (newStat > 0) {
-                    // tell the protester to get stunned
-                    // if the protester is aleady stunned, reset their stun duration
-                    int stunTime = (50 > 100 - getWorld()->getLevel() * 10) ? 50 : 100 - getWorld()->getLevel() * 10;
-                    temp->changeTicks(stunTime - temp->getTicks());
-
-                    // tell the protester to sound annoyed
-                    temp->playAnnoyed();
-
-                    temp->changeStunned(true); // set the protester to stunned
-                }
-
-                return true; // return true since a Protester was hit
-            }
+    // visit the protesters within three units of the Squirt until one is hit
+    // returns true if a Protester was hit
+    return getWorld()->forEachProtesterNear(getX(), getY(), 3, [&](ProtesterTemplate* protester) {
+        // if this protester is already stunned, move onto the next one
+        if (protester->getStunned())
+            return false;
+
+        // retrieve the protester's health before and after getting squirted
+        int currStat = protester->getHitPoints();
+        protester->changeHitPoints(-2);
+        int newStat = protester->getHitPoints();
+
+        // increase the score accordingly if the Protester's health reaches 0
+        if (currStat > 0 && newStat <= 0)
+            getWorld()->increaseScore(protester->getGiveUpScore());
+
+        // if the Protester is not dead, then stun it and make it sound annoyed
+        if (newStat > 0) {
+            // tell the protester to get stunned
+            // if the protester is aleady stunned, reset their stun duration
+            int stunTime = (50 > 100 - getWorld()->getLevel() * 10) ? 50 : 100 - getWorld()->getLevel() * 10;
+            protester->changeTicks(stunTime - protester->getTicks());
+
+            // tell the protester to sound annoyed
+            protester->playAnnoyed();
+
+            protester->changeStunned(true); // set the protester to stunned
         }
 
-        it++; // move onto the next obj in the list
-    }
-
-    return false; // return false since a Protester was not hit
+        return true; // stop looking since a Protester was hit
+    });
 }
 
 // base class for TunnelMan and Protesters
@@ -686,7 +770,7 @@ void Actor::moveDir(int dir, bool digEarth)
     // if the direction the actor is facing in is equal to the direction to be moved in
     if (getDirection() == move) {
         // if the area is out of bounds, immediately return
-        if (x < 0 || x > 60 || y < 0 || y > 60)
+        if (x < 0 || x > getWorld()->getMaxX() || y < 0 || y > getWorld()->getMaxY())
             return;
 
         // get a pointer to StudentWorld
@@ -699,36 +783,29 @@ void Actor::moveDir(int dir, bool digEarth)
         // defaulted to false, used to check whether to play dig sound or not. only becomes true when Earth is dug
         bool pSound = false;
 
+        // get the bitboard layer of Earth and Boulders
+        const Terrain& terrain = temp->getTerrain();
+
         // depending on the direction to be moved in
         // change tempX and tempY to check if the new intended actor position is occupied by Boulders or Earth
         // if the new position overlaps with a Boulder, return immediately
-        // if the new positoin overlaps with Earth, if digEarth is true, then make the Earth invisible and
+        // if the new positoin overlaps with Earth, if digEarth is true, then dig out the Earth and
         // set pSound to true to play the dig sound. if digEarth is false, return immediately
         switch (move) {
         case up:
             tempY += 3;
         case down: {
-            for (int i = tempX; i < tempX + SPRITE_WIDTH; i++) {
-                if (temp->getPixelArrID(i, tempY) == TID_BOULDER || (!digEarth && temp->getPixelArrID(i, tempY) == TID_EARTH))
-                    return;
-                if (temp->getPixelArrID(i, tempY) == TID_EARTH) {
-                    temp->setEarthInvis(i, tempY);
-                    pSound = true;
-                }
-            }
+            if (terrain.boulderIn(tempX, tempY, SPRITE_WIDTH, 1) || (!digEarth && terrain.earthIn(tempX, tempY, SPRITE_WIDTH, 1)))
+                return;
+            pSound = temp->digEarth(tempX, tempY, SPRITE_WIDTH, 1);
             break;
         }
         case right:
             tempX += 3;
         case left: {
-            for (int i = tempY; i < tempY + SPRITE_HEIGHT; i++) {
-                if (temp->getPixelArrID(tempX, i) == TID_BOULDER || (!digEarth && temp->getPixelArrID(tempX, i) == TID_EARTH))
-                    return;
-                if (temp->getPixelArrID(tempX, i) == TID_EARTH) {
-                    temp->setEarthInvis(tempX, i);
-                    pSound = true;
-                }
-            }
+            if (terrain.boulderIn(tempX, tempY, 1, SPRITE_HEIGHT) || (!digEarth && terrain.earthIn(tempX, tempY, 1, SPRITE_HEIGHT)))
+                return;
+            pSound = temp->digEarth(tempX, tempY, 1, SPRITE_HEIGHT);
             break;
         }
         }
@@ -751,10 +828,11 @@ void Actor::moveDir(int dir, bool digEarth)
     // if the code reaches this point, then move == none, so nothing should happen
 }
 
-// creates a new TunnelMan object, which always spawns in at (30, 60) with 5 water, 0 nuggets, and 1 sonar charge
+// creates a new TunnelMan object, which always spawns in at the top of the center shaft ((30, 60) in the game's own field)
+// with 5 water, 0 nuggets, and 1 sonar charge
 // the barrels holds the amount of barrels to be collected, not the amount of barrels the player has
 TunnelMan::TunnelMan(StudentWorld* worldIn, int numBarrels)
-    : Actor(worldIn, TID_PLAYER, 30, 60, Direction::right, 10)
+    : Actor(worldIn, TID_PLAYER, worldIn->getWidth() / 2 - 2, worldIn->getMaxY(), Direction::right, 10)
 {
     // initialize TunnelMan's private variables to their default values
     squirts = 5;
@@ -873,28 +951,11 @@ void TunnelMan::useSonar()
     int x1 = getX();
     int y1 = getY();
 
-    // get the list of objs in play
-    std::list<obj*> actors = getWorld()->getActors();
-
-    // iterate through each obj in the list
-    std::list<obj*>::iterator it = actors.begin();
-    while (it != actors.end()) {
-        // if the obj is not visible
-        if (!(*it)->isVisible()) {
-            // get the obj's coordinates
-            int x2 = (*it)->getX();
-            int y2 = (*it)->getY();
-
-            // calculate the distance between the obj and TunnelMan
-            double dist = getWorld()->calcDist(x1, y1, x2, y2);
-
-            // if the obj is within 12 units of TunnelMan, make it visble
-            if (dist <= 12.0)
-                (*it)->setVisible(true);
-        }
-
-        it++; // move onto the next obj in the list
-    }
+    // make every hidden obj within 12 units of TunnelMan visible
+    getWorld()->forEachHiddenNear(x1, y1, 12, [](obj* hidden) {
+        hidden->setVisible(true);
+        return false; // keep looking for more hidden objs
+    });
 }
 
 // attempt to drop a nugget
@@ -907,54 +968,46 @@ void TunnelMan::dropNugget()
     nuggets--; // decrement the amount of nuggets held by TunnelMan
 
     // create a new GoldNugget object that is able to be picked up by protesters at TunnelMan's location
-    // and add it to the list of actors
-    GoldNugget* temp = new GoldNugget(getX(), getY(), 100, true, getWorld());
-    getWorld()->getActors().push_back(temp);
+    // it joins the goods in the game at the end of this tick
+    getWorld()->spawnNugget(getX(), getY(), 100, true);
 }
 
 // checks if a nugget was already dropped in this location
 bool TunnelMan::nuggetDroppedHere()
 {
-    // gets list of obj in the game
-    std::list<obj*> actors = getWorld()->getActors();
-
     // gets current coordinates
     int x = getX();
     int y = getY();
 
-    // iterate through obj in game
-    std::list<obj*>::iterator it = actors.begin();
-    while (it != actors.end()) {
-        // if an object is gold
-        if ((*it)->getID() == TID_GOLD) {
-            // get the coordinates of the gold
-            int x1 = (*it)->getX();
-            int y1 = (*it)->getY();
-
-            // if there is any overlap with the bootom left corner, return true
-            if (x1 >= x && x1 <= x + 3 && y1 >= y && y1 <= y + 3)
-                return true;
-
-            // if there is any overlap with the bottom right corner, return true
-            x1 += 3;
-            if (x1 >= x && x1 <= x + 3 && y1 >= y && y1 <= y + 3)
-                return true;
-
-            // if there is any overlap with the upper right corner, return true
-            y1 += 3;
-            if (x1 >= x && x1 <= x + 3 && y1 >= y && y1 <= y + 3)
-                return true;
-
-            // if there is any overlap with the upper left corner, return true
-            x1 -= 3;
-            if (x1 >= x && x1 <= x + 3 && y1 >= y && y1 <= y + 3)
-                return true;
-        }
+    // any overlapping nugget has its corner within 3 units along each axis, so it is within 5 units
+    // visit the objs near TunnelMan and return true as soon as an overlapping nugget is found
+    return getWorld()->forEachGoodsNear(x, y, 5, [&](Goods* good) {
+        // if the good is not gold, keep looking
+        if (!good->isGold())
+            return false;
 
-        it++; // move onto the next obj
-    }
+        // get the coordinates of the gold
+        int x1 = good->getX();
+        int y1 = good->getY();
+
+        // if there is any overlap with the bootom left corner, return true
+        if (x1 >= x && x1 <= x + 3 && y1 >= y && y1 <= y + 3)
+            return true;
+
+        // if there is any overlap with the bottom right corner, return true
+        x1 += 3;
+        if (x1 >= x && x1 <= x + 3 && y1 >= y && y1 <= y + 3)
+            return true;
+
+        // if there is any overlap with the upper right corner, return true
+        y1 += 3;
+        if (x1 >= x && x1 <= x + 3 && y1 >= y && y1 <= y + 3)
+            return true;
 
-    return false; // there is no overlap, so return false
+        // if there is any overlap with the upper left corner, return true
+        x1 -= 3;
+        return x1 >= x && x1 <= x + 3 && y1 >= y && y1 <= y + 3;
+    });
 }
 
 // attempt to fire a squirt
@@ -993,17 +1046,17 @@ void TunnelMan::fireSquirt()
     }
     }
 
-    // create a new squirt object at (x, y) facing direction move and add it to the list of objs active in game
-    Squirt* temp = new Squirt(x, y, move, getWorld());
-    getWorld()->getActors().push_back(temp);
+    // create a new squirt object at (x, y) facing direction move
+    // it joins the squirts active in game at the end of this tick
+    getWorld()->spawnSquirt(x, y, move);
 
     getWorld()->playSound(SOUND_PLAYER_SQUIRT); // play the sound to signify that a squirt was used
 }
 
 // base class for Protesters to be derived from
-// all Protesters start at (60, 60) facing left
+// all Protesters start at the exit in the top right corner ((60, 60) in the game's own field) facing left
 ProtesterTemplate::ProtesterTemplate(StudentWorld* worldIn, int id, int hp, bool reg)
-    : Actor(worldIn, id, 60, 60, Direction::left, hp)
+    : Actor(worldIn, id, worldIn->getMaxX(), worldIn->getMaxY(), Direction::left, hp)
 {
     numSquaresToMoveInCurrentDirection = calcSteps(); // calculate number of squares to move
 
@@ -1014,6 +1067,8 @@ ProtesterTemplate::ProtesterTemplate(StudentWorld* worldIn, int id, int hp, bool
 
     isStunned = false; // the protestesr does not begin stunned
 
+    isLeaving = false; // the protester does not begin leaving the field
+
     isReg = reg; // mark this protester depending on its type
 }
 
@@ -1022,6 +1077,24 @@ ProtesterTemplate::~ProtesterTemplate()
 {
 }
 
+// moves this protester to its new bucket in the spatial grid of protesters
+void ProtesterTemplate::moved(int oldX, int oldY)
+{
+    getWorld()->protesterMoved(this, oldX, oldY);
+}
+
+// a protester with no hit points leaves the field, so it cannot stay asleep until its rest is over
+void ProtesterTemplate::hitPointsRanOut()
+{
+    catchUp();
+}
+
+// the world's timer wheel counts the turns the protester slept through, which come off the rest left
+void ProtesterTemplate::catchUp()
+{
+    ticksToWaitBetweenMoves -= int(getWorld()->wake(this));
+}
+
 // tells protesters what to do every tick
 // only one action is exclusive to hardcore protesters
 void ProtesterTemplate::doSomething()
@@ -1042,33 +1115,24 @@ void ProtesterTemplate::doSomething()
 
         // if the protester is at the exit location, set it to dead
         // then immediately return so it can be deleted
-        if (getX() == 60 && getY() == 60) {
+        if (getX() == getWorld()->getMaxX() && getY() == getWorld()->getMaxY()) {
             setDead();
             return;
         }
 
-        // create a pointer to the exit path
-        std::stack<std::pair<int, int> >* exit = getExitPath();
-
-        // if the exit path is empty
-        if (exit->empty()) {
-            // then the protester's health just reached 0, so play its give up sound
+        // if the protester just gave up, play its give up sound
+        if (!isLeaving) {
             getWorld()->playSound(SOUND_PROTESTER_GIVE_UP);
 
-            // then create the path to the exit
-            makeExitPath();
+            isLeaving = true;
         }
 
-        // once the exit path is created
-        if (!exit->empty()) {
-            // get the next coordinate in the path and delete it from the path
-            std::pair<int, int> currCoord = exit->top();
-            exit->pop();
+        // get the next coordinate on the shared path to the exit
+        std::pair<int, int> currCoord = getWorld()->getExitStep(getX(), getY());
 
-            // make the protester face the new direction and move to the coordinates
-            setCoorDir(currCoord);
-            moveTo(currCoord.first, currCoord.second);
-        }
+        // make the protester face the new direction and move to the coordinates
+        setCoorDir(currCoord);
+        moveTo(currCoord.first, currCoord.second);
 
         // the protester just acted, so reset their rest ticks
         changeTicks(calcTicks() - getTicks());
@@ -1077,8 +1141,10 @@ void ProtesterTemplate::doSomething()
     }
 
     // if the protester is resting, decrement their rest ticks and immediately return
+    // every tick of the rest after this one only counts down too, so sleep through them
     if (getTicks() > 0) {
         changeTicks(-1);
+        getWorld()->sleepFor(this, getTicks());
         return;
     }
 
@@ -1118,20 +1184,17 @@ void ProtesterTemplate::doSomething()
     // section exclusive to hardcore protesters
     // action to take if protester is hardcore / not reg
     if (!isReg) {
-        // is a hardcore protester, so downcast to use its methods
-        HardProtester* temp = dynamic_cast<HardProtester*>(this);
-
-        temp->makePlayerPath(); // create a path to the player
-
-        std::stack<std::pair<int, int> >* playerPathTemp = temp->getPlayerPath();
+        // get the number of moves to the player from the player field shared by all protesters
+        // this is -1 if the player is not within the chase range (16 + level * 2 moves)
+        int playerDist = getWorld()->getPlayerDist(getX(), getY());
 
         // if the path is less than a certain number of moves
-        if (playerPathTemp->size() < (16 + getWorld()->getLevel() * 2) && !playerPathTemp->empty()) {
+        if (playerDist > 0 && playerDist < getWorld()->getChaseRange()) {
             Direction oldDir = getDirection(); // get soon to be old direction
 
             // tell the protester to move one step on the path towards the protester
             // if protester turns, reset the turn count (set to 201 because will be immediately decremented)
-            setCoorDir(playerPathTemp->top());
+            setCoorDir(getWorld()->getPlayerStep(getX(), getY()));
             Direction dir = getDirection();
             int direction = 0;
             switch (dir) {
@@ -1382,14 +1445,19 @@ int ProtesterTemplate::calcSteps()
 }
 
 // returns number of ticks left to wait until moving
+// the rest ticks slept through are taken off first, and the protester acts normally from then on
 int ProtesterTemplate::getTicks()
 {
+    catchUp();
+
     return ticksToWaitBetweenMoves;
 }
 
-// changes number of ticks to wait before moving
+// changes number of ticks to wait before moving, catching up on any rest ticks slept through first
 void ProtesterTemplate::changeTicks(int change)
 {
+    catchUp();
+
     ticksToWaitBetweenMoves += change;
 }
 
@@ -1456,137 +1524,8 @@ void ProtesterTemplate::changeStunned(bool change)
     isStunned = change;
 }
 
-// fills exitPath with coordinates from current location to exit point (60, 60)
-void ProtesterTemplate::makeExitPath()
-{
-    exitPath = makePathTo(60, 60);
-}
-
-// returns pointer to exitPath
-std::stack<std::pair<int, int> >* ProtesterTemplate::getExitPath()
-{
-    return &exitPath;
-}
-
-// returns a stack with coordinates showing the path from current location to (targetX, targetY)
-std::stack<std::pair<int, int> > ProtesterTemplate::makePathTo(int targetX, int targetY)
-{
-    // creates a pointer to the StudentWorld this protester belongs to
-    StudentWorld* temp = getWorld();
-
-    // fills the map private member with a copy of the hash table of Earth and Boulders in StudentWorld
-    // must be a copy because values will be changed when making path
-    for (int i = 0; i < 64; i++)
-        for (int j = 0; j < 64; j++)
-            map[j][i] = temp->getPixelArrID(j, i);
-
-    std::queue<coord> exit; // create a queue to use for BFS search
-
-    // arbitrarily chosen, for use in creating a path for protesters
-    const int FOUND = 500;
-
-    exit.push(coord(std::pair<int, int>(getX(), getY()), FOUND)); // push the current coordinates into the queue
-
-    int dist = FOUND; // pick an arbitrary variable to use in marking distance from current location
-
-    map[getX()][getY()] = FOUND; // mark current location on map as found
-
-    // while the queue is not empty
-    while (!exit.empty()) {
-        // get the front item of the queue
-        coord currLoc = exit.front();
-
-        // get the coordinates of the front item
-        int currX = currLoc.xy.first;
-        int currY = currLoc.xy.second;
-        // get the distance of these coordinates from the current location
-        dist = currLoc.num;
-
-        // if target found, exit the loop
-        if (currX == targetX && currY == targetY) {
-            break;
-        }
-
-        exit.pop(); // remove front item from queue
-
-        // if spot to right of coordinates is open and undiscovered
-        if (currX + 1 >= 0 && currX + 1 <= 60 && currY >= 0 && currY <= 60 && map[currX + 1][currY] < FOUND && !getWorld()->dirtHere(currX + 1, currY)) {
-            // push it into the queue and mark its location on the map with its distance from current location
-            exit.push(coord(std::pair<int, int>(currX + 1, currY), dist + 1));
-            map[currX + 1][currY] = dist + 1;
-        }
-
-        // if spot above coordinates is open and undiscovered
-        if (currY + 1 >= 0 && currY + 1 <= 60 && currX >= 0 && currX <= 60 && map[currX][currY + 1] < FOUND && !getWorld()->dirtHere(currX, currY + 1)) {
-            // push it into the queue and mark its location on the map with its distance from current location
-            exit.push(coord(std::pair<int, int>(currX, currY + 1), dist + 1));
-            map[currX][currY + 1] = dist + 1;
-        }
-
-        // if spot to left of coordinates is open and undiscovered
-        if (currX - 1 >= 0 && currX - 1 <= 60 && currY >= 0 && currY <= 60 && map[currX - 1][currY] < FOUND && !getWorld()->dirtHere(currX - 1, currY)) {
-            // push it into the queue and mark its location on the map with its distance from current location
-            exit.push(coord(std::pair<int, int>(currX - 1, currY), dist + 1));
-            map[currX - 1][currY] = dist + 1;
-        }
-
-        // if spot below  coordinates is open and undiscovered
-        if (currY - 1 >= 0 && currY - 1 <= 60 && currX >= 0 && currX <= 60 && map[currX][currY - 1] < FOUND && !getWorld()->dirtHere(currX, currY - 1)) {
-            // push it into the queue and mark its location on the map with its distance from current location
-            exit.push(coord(std::pair<int, int>(currX, currY - 1), dist + 1));
-            map[currX][currY - 1] = dist + 1;
-        }
-    }
-
-    std::stack<std::pair<int, int> > returnQ; // create a stack to store the coordinates in the path
-
-    // push target coordinates into stack
-    returnQ.push(std::pair<int, int>(targetX, targetY));
-
-    while (!(targetX == getX() && targetY == getY())) {
-        dist--; // decrement dist to the dist that must be adjacent to (targetX, targetY) on map
-
-        // if coordinate to the left on map contains dist
-        targetX--;
-        if (targetX >= 0 && targetX <= 60 && targetY >= 0 && targetY <= 60 && map[targetX][targetY] == dist) {
-            //push this coordinate into the stack and continue finding the next coordinate
-            returnQ.push(std::pair<int, int>(targetX, targetY));
-            continue;
-        }
-
-        // if coordinate to the right on map contains dist
-        targetX += 2;
-        if (targetX >= 0 && targetX <= 60 && targetY >= 0 && targetY <= 60 && map[targetX][targetY] == dist) {
-            //push this coordinate into the stack and continue finding the next coordinate
-            returnQ.push(std::pair<int, int>(targetX, targetY));
-            continue;
-        }
-
-        // if coordinate below on map contains dist
-        targetX--;
-        targetY--;
-        if (targetX >= 0 && targetX <= 60 && targetY >= 0 && targetY <= 60 && map[targetX][targetY] == dist) {
-            //push this coordinate into the stack and continue finding the next coordinate
-            returnQ.push(std::pair<int, int>(targetX, targetY));
-            continue;
-        }
-
-        // if coordinate above on map contains dist
-        targetY += 2;
-        if (targetX >= 0 && targetX <= 60 && targetY >= 0 && targetY <= 60 && map[targetX][targetY] == dist) {
-            //push this coordinate into the stack and continue finding the next coordinate
-            returnQ.push(std::pair<int, int>(targetX, targetY));
-            continue;
-        }
-    }
-
-    returnQ.pop(); // pop the top coordinate off of the stack, which is the current location of the protester
-
-    return returnQ; // return the stack of coordinates to the location inputted
-}
-
 // get the direction the protester must face to face TunnelMan
-GraphObject::Direction ProtesterTemplate::getTunnelManDir()
+obj::Direction ProtesterTemplate::getTunnelManDir()
 {
     // creates a pointer to TunnelMan and get its coordinates
     TunnelMan* player = getWorld()->getPlayer();
@@ -1703,7 +1642,7 @@ bool ProtesterTemplate::noDirtBetweenPlayer()
 }
 
 // generate and return a random direction
-GraphObject::Direction ProtesterTemplate::genDir()
+obj::Direction ProtesterTemplate::genDir()
 {
     // generate a random number from 1 to 4
     int dir = getWorld()->RNG(1, 4);
@@ -1748,37 +1687,20 @@ bool ProtesterTemplate::checkDirMove(Direction dir)
     }
     }
 
+    // get the bitboard layer of Earth and Boulders
+    const Terrain& terrain = getWorld()->getTerrain();
+
     // check if the new pixels being occupied are in bounds and not Earth or Boulders
     switch (dir) {
-    // in the left and right directions
+    // in the left and right directions, check the new column of pixels
     case right:
-    case left: {
-        // for each new pixel occupised
-        for (int i = y; i < y + SPRITE_HEIGHT; i++) {
-            int ID = getWorld()->getPixelArrID(x, i); // get the pixel's ID
-
-            // if the new pixel location is invalid, return false
-            if (ID == TID_BOULDER || ID == TID_EARTH || ID == OUT_OF_BOUNDS)
-                return false;
-        }
-
-        break;
-    }
+    case left:
+        return x >= 0 && x < getWorld()->getWidth() && !terrain.columnDirt(x, y, SPRITE_HEIGHT);
 
-    // in the up and down directions
+    // in the up and down directions, check the new row of pixels
     case up:
-    case down: {
-        // for each new pixel occupied
-        for (int i = x; i < x + SPRITE_WIDTH; i++) {
-            int ID = getWorld()->getPixelArrID(i, y); // get the pixel's ID
-
-            // if the new pixel location is invalid, return false
-            if (ID == TID_BOULDER || ID == TID_EARTH || ID == OUT_OF_BOUNDS)
-                return false;
-        }
-
-        break;
-    }
+    case down:
+        return y >= 0 && y < getWorld()->getHeight() && !terrain.rowDirt(x, y, SPRITE_WIDTH);
     }
 
     return true; // if the code reaches this point, it is possible to move in dir, so return true
@@ -1812,6 +1734,12 @@ void RegularProtester::gotGold()
     changeHitPoints(-5); // tell the protester to leave the field
 }
 
+// score for squirting a regular protester until it gives up
+int RegularProtester::getGiveUpScore()
+{
+    return 100;
+}
+
 // hardcore protester class constructor
 HardProtester::HardProtester(StudentWorld* worldIn)
     : ProtesterTemplate(worldIn, TID_HARD_CORE_PROTESTER, 20, false)
@@ -1834,17 +1762,8 @@ void HardProtester::gotGold()
     changeTicks(((50 > 100 - getWorld()->getLevel() * 10) ? 50 : 100 - getWorld()->getLevel() * 10) - getTicks());
 }
 
-// set playerPath to contain a path leading to the player
-void HardProtester::makePlayerPath()
+// score for squirting a hardcore protester until it gives up
+int HardProtester::getGiveUpScore()
 {
-    TunnelMan* temp = getWorld()->getPlayer(); // create a pointer to TunnelMan
-
-    // set playerPath to a stack containing a path to TunnelMan's coordinates
-    playerPath = makePathTo(temp->getX(), temp->getY());
+    return 250;
 }
-
-// returns pointer to path to TunnelMan
-std::stack<std::pair<int, int> >* HardProtester::getPlayerPath()
-{
-    return &playerPath;
-}
\ No newline at end of file
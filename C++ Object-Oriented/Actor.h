@@ -1,15 +1,17 @@
 #ifndef ACTOR_H_
 #define ACTOR_H_
 
-#include "GraphObject.h"
 #include "GameConstants.h"
+#include "TerrainListener.h"
+#include "TimerWheel.h"
+#include <string>
 #include <map>
 #include <vector>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
-#include <stack>
 #include <utility>
+#include <limits.h>
 
 class StudentWorld;
 
@@ -18,8 +20,13 @@ class StudentWorld;
 const int OUT_OF_BOUNDS = 27;
 
 // base class for all actors
-class obj : public GraphObject {
+// objs only hold their own position, direction, and visibility, and do not draw themselves
+// a frontend (e.g. GlutWorld) reads this state after every tick to draw them
+class obj {
 public:
+    // directions an obj can face, in the same order as GraphObject::Direction
+    enum Direction { none, up, down, left, right };
+
     // constructor
     obj(int hp, int imageID, int startX, int startY, StudentWorld* worldIn, Direction dir, double size, unsigned int depth);
 
@@ -32,6 +39,26 @@ public:
     // returns if obj should stay on field
     virtual bool getStatus();
 
+    // moves obj to (x, y), keeping StudentWorld's spatial grid up to date
+    void moveTo(int x, int y);
+
+    // returns coordinates
+    int getX() const;
+    int getY() const;
+
+    // returns / changes the direction obj is facing
+    Direction getDirection() const;
+    void setDirection(Direction dir);
+
+    // returns / changes whether obj should be drawn
+    bool isVisible() const;
+    void setVisible(bool shouldDisplay);
+
+    // returns the image, size, and depth the frontend draws obj with
+    int getID() const;
+    double getSize() const;
+    unsigned int getDepth() const;
+
     StudentWorld* getWorld(); // returns StudentWorld pointer for use by child classes
 
     // increments hit points / ticks
@@ -40,27 +67,38 @@ public:
     // returns hit points
     int getHitPoints();
 
-private:
-    StudentWorld* world; // contains pointer to StudentWorld that object belongs to
-    int health; // hit points OR ticks left
-};
+    // deletes this obj once StudentWorld is done with it
+    // kinds that StudentWorld keeps in an ObjectPool override this to give their slot back instead
+    virtual void destroy();
 
-// class for Earth to fill map
-class Earth : public obj {
-public:
-    // constructs a visible Earth object at (x, y)
-    // -1 for ticks since ticks are not decremented during game
-    Earth(int x, int y, StudentWorld* worldIn);
+    // returns where obj is on StudentWorld's TimerWheel for its kind, for the kinds that sleep
+    wheelLink& getWheelLink();
 
-    // virtual destructor
-    virtual ~Earth();
+protected:
+    // called by moveTo after obj moved from (oldX, oldY), so StudentWorld can refile it
+    // does nothing by default, since only some kinds of obj are filed in a spatial grid
+    virtual void moved(int oldX, int oldY);
 
-    // empty method, but mandatory since is derived from obj
-    virtual void doSomething();
+    // called by changeHitPoints whenever it leaves obj with no hit points
+    // does nothing by default, kinds that sleep wake up here since running out always changes what they do
+    virtual void hitPointsRanOut();
+
+private:
+    StudentWorld* world; // contains pointer to StudentWorld that object belongs to
+    wheelLink link; // where obj is on the TimerWheel for its kind, unused by the kinds that never sleep
+    int health; // hit points OR ticks left
+    int imageID; // which image the frontend draws this obj with
+    int x; // current x coordinate
+    int y; // current y coordinate
+    Direction facing; // direction obj is facing
+    double size; // how large the frontend draws this obj
+    unsigned int depth; // how far back the frontend draws this obj
+    bool visible; // whether the frontend should draw this obj
 };
 
 // class for boulder type objects in game
-class Boulder : public obj {
+// a stable Boulder watches the row under it, so it only looks at the terrain after something there changed
+class Boulder : public obj, public TerrainListener {
 public:
     // constructor that accepts coordinates and pointer to StudentWorld boulder belongs to
     Boulder(int x, int y, StudentWorld* worldIn);
@@ -74,8 +112,12 @@ public:
     // returns if Boulder should stay on map during game
     virtual bool getStatus();
 
+    // notes that the row under the Boulder changed, so the next tick checks whether it still holds the Boulder up
+    virtual void terrainChanged(int x, int y, int w, int h);
+
 private:
     std::string status; // keeps track of whether Boulder is falling, waiting, or dead
+    bool supportChanged; // true if the row under a stable Boulder changed since it last checked
     bool dirtUnder(); // checks if there is Earth or a Boulder beneath this Boulder
     void checkMoveCollisions(); // check if the Boulder hits a Protester or TunnelMan
 };
@@ -88,6 +130,13 @@ public:
 
     // virtual destructor
     virtual ~Goods();
+
+    // returns true if this good is a GoldNugget, false by default
+    virtual bool isGold();
+
+protected:
+    // refiles this good in StudentWorld's spatial grid of goods
+    virtual void moved(int oldX, int oldY);
 };
 
 // class for oil barrel items on screen
@@ -115,6 +164,9 @@ public:
     // tells sonar what to do every tick
     virtual void doSomething();
 
+    // gives this Sonar's slot back to StudentWorld's pool
+    virtual void destroy();
+
 private:
     int calcTicks(); // calculates amount of ticks for sonar to stay in game
 };
@@ -131,6 +183,12 @@ public:
     // tells GoldNugget what to do every tick
     virtual void doSomething();
 
+    // returns true, since this good is a GoldNugget
+    virtual bool isGold();
+
+    // gives this GoldNugget's slot back to StudentWorld's pool
+    virtual void destroy();
+
 private:
     bool protestersSee; // true if protesters can pick up the gold, false if TunnelMan can
 };
@@ -147,6 +205,9 @@ public:
     // tells WaterPool what to do every tick
     virtual void doSomething();
 
+    // gives this WaterPool's slot back to StudentWorld's pool
+    virtual void destroy();
+
 private:
     int calcTicks(); // calculates amount of ticks for WaterPool to stay in game
 };
@@ -155,7 +216,7 @@ private:
 class Squirt : public obj {
 public:
     // constructor
-    Squirt(int x, int y, GraphObject::Direction dir, StudentWorld* worldIn);
+    Squirt(int x, int y, obj::Direction dir, StudentWorld* worldIn);
 
     // virtual destructor
     virtual ~Squirt();
@@ -163,6 +224,9 @@ public:
     // tells Squirt what to do every tick
     virtual void doSomething();
 
+    // gives this Squirt's slot back to StudentWorld's pool
+    virtual void destroy();
+
 private:
     bool checkMoveCollisions(); // check if Squirt hits a protester
 };
@@ -268,9 +332,6 @@ public:
     // changes stun status
     void changeStunned(bool change);
 
-    // returns a stack with directions from the current coordinatse to (targetX, targetY)
-    std::stack<std::pair<int, int> > makePathTo(int targetX, int TargetY);
-
     // play an annoyed sound, used by other classes when damage is dealt
     void playAnnoyed();
 
@@ -278,19 +339,20 @@ public:
     // used when protesters pick up gold nuggets
     virtual void gotGold() = 0;
 
+    // virtual function
+    // returns the score for squirting this protester until it gives up
+    virtual int getGiveUpScore() = 0;
+
+protected:
+    // refiles this protester in StudentWorld's spatial grid of protesters
+    virtual void moved(int oldX, int oldY);
+
+    // wakes a protester that ran out of hit points while resting, so it starts leaving on its next turn
+    virtual void hitPointsRanOut();
+
 private:
-    // struct to use for generating paths
-    struct coord {
-        // constructor
-        coord(std::pair<int, int> m_xy, int dist)
-        {
-            xy = m_xy;
-            num = dist;
-        }
-
-        std::pair<int, int> xy; // contains coordinates to move to
-        int num; // contains number of steps away from start of path
-    };
+    // takes the rest ticks slept through off the rest, and wakes the protester if it was sleeping
+    void catchUp();
 
     // returns number of ticks to wait between moves for protester
     int calcTicks();
@@ -316,12 +378,6 @@ private:
     // changes ticks to wait before turning at an intersection
     void changeTurn(int change);
 
-    // creates a path to the exit (60, 60) and places it into exitPath
-    void makeExitPath();
-
-    // returns pointer to exitPath
-    std::stack<std::pair<int, int> >* getExitPath();
-
     // sets the direction of protesters in the direction of coord
     void setCoorDir(std::pair<int, int> coord);
 
@@ -345,8 +401,7 @@ private:
     int shoutCount; // number of nonresting ticks before protester is allowed to shout
     int perpTurn; // number of nonresting ticks before protester is forced to turn at intersection
     bool isStunned; // if the protester is stunned or not
-    int map[64][64]; // map to use when generating a path
-    std::stack<std::pair<int, int> > exitPath; // will hold path to exit
+    bool isLeaving; // if the protester has given up and is walking to the exit
 };
 
 // class for regular protestors
@@ -361,6 +416,9 @@ public:
     // tells protester what to do when picking up gold
     // used by GoldNugget class
     virtual void gotGold();
+
+    // returns 100, the score for making a regular protester give up
+    virtual int getGiveUpScore();
 };
 
 // class for hardcore protesters
@@ -376,14 +434,8 @@ public:
     // used by GoldNugget class
     virtual void gotGold();
 
-    // creates a path from current coordinates to TunnelMan
-    void makePlayerPath();
-
-    // returns pointer to path to player
-    std::stack<std::pair<int, int> >* getPlayerPath();
-
-private:
-    std::stack<std::pair<int, int> > playerPath; // contains path to player
+    // returns 250, the score for making a hardcore protester give up
+    virtual int getGiveUpScore();
 };
 
 #endif // ACTOR_H_
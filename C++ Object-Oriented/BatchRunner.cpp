@@ -0,0 +1,66 @@
+#include "BatchRunner.h"
+#include "HeadlessGame.h"
+#include "ThreadPool.h"
+#include <chrono>
+
+// feeds the policy's keys to the game one tick at a time until the game ends or reaches a limit
+sessionReport runSession(const sessionConfig& config)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    HeadlessGame game(config.seed, config.lives, config.width, config.height);
+    InputPolicy* input = makeInputPolicy(config.input, config.seed);
+
+    long ticks = 0;
+    while (ticks < config.maxTicks && !game.isGameOver() && game.getLevel() < config.maxLevel) {
+        int key;
+        if (input->nextKey(key))
+            game.pushKey(key);
+
+        game.tick();
+        ticks++;
+    }
+
+    delete input;
+
+    // record the results
+    sessionReport report;
+    report.seed = config.seed;
+    report.score = game.getScore();
+    report.lives = game.getLives();
+    report.level = game.getLevel();
+    report.ticks = ticks;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return report;
+}
+
+// every task writes only to its own slot of reports, so no locking is needed
+std::vector<sessionReport> runBatch(const std::vector<sessionConfig>& configs, int threads)
+{
+    std::vector<sessionReport> reports(configs.size());
+
+    ThreadPool pool(threads);
+    for (size_t i = 0; i < configs.size(); i++)
+        pool.submit([&configs, &reports, i] { reports[i] = runSession(configs[i]); });
+
+    pool.wait();
+
+    return reports;
+}
+
+// ticks per second is measured against the wall time of the whole batch, so it shows how well the batch scaled
+void printBatchReport(const std::vector<sessionReport>& reports, double seconds, FILE* out)
+{
+    long totalTicks = 0;
+
+    fprintf(out, "%20s %8s %6s %6s %10s %10s\n", "seed", "score", "lives", "level", "ticks", "seconds");
+    for (size_t i = 0; i < reports.size(); i++) {
+        const sessionReport& r = reports[i];
+        fprintf(out, "%20llu %8u %6u %6u %10ld %10.3f\n", (unsigned long long)r.seed, r.score, r.lives, r.level, r.ticks, r.seconds);
+        totalTicks += r.ticks;
+    }
+
+    fprintf(out, "%zu sessions, %ld ticks in %.3f s (%.0f ticks/s)\n", reports.size(), totalTicks, seconds,
+        seconds > 0 ? totalTicks / seconds : 0.0);
+}
@@ -0,0 +1,40 @@
+#ifndef BATCHRUNNER_H_
+#define BATCHRUNNER_H_
+
+#include "InputPolicy.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// struct describing one headless game for runBatch to play
+struct sessionConfig {
+    uint64_t seed; // seeds both the world and the input policy
+    InputPolicy::Kind input; // what presses the keys
+    long maxTicks; // stop after this many ticks
+    unsigned int maxLevel; // stop once the player reaches this level
+    unsigned int lives; // lives the player starts with
+    int width; // width of the field, 64 in the game itself
+    int height; // height of the field including the top band, 64 in the game itself
+};
+
+// struct holding the results of one game played by runBatch
+struct sessionReport {
+    uint64_t seed; // seed the game was played with
+    unsigned int score; // final score
+    unsigned int lives; // lives left at the end
+    unsigned int level; // level reached
+    long ticks; // ticks played
+    double seconds; // wall time taken to play the game
+};
+
+// plays one game headless and reports how it went
+sessionReport runSession(const sessionConfig& config);
+
+// plays every game in configs on a ThreadPool with threads workers, and returns their reports in the same order
+// each game owns its own world and generator, so the games share nothing while they run
+std::vector<sessionReport> runBatch(const std::vector<sessionConfig>& configs, int threads);
+
+// prints one line per report, followed by the totals
+void printBatchReport(const std::vector<sessionReport>& reports, double seconds, FILE* out);
+
+#endif // BATCHRUNNER_H_
@@ -0,0 +1,50 @@
+#ifndef GAMEFRONTEND_H_
+#define GAMEFRONTEND_H_
+
+#include <string>
+
+class obj;
+
+// everything StudentWorld needs from outside of the simulation: input, sound, the status line,
+// the level / lives / score kept between levels, and notices about what to draw
+// GlutWorld implements this on top of the GLUT controller, HeadlessGame implements it with plain counters
+class GameFrontend {
+public:
+    // virtual destructor
+    virtual ~GameFrontend() {}
+
+    // returns true and sets value to the key pressed since the last tick, false if no key was pressed
+    virtual bool getKey(int& value) = 0;
+
+    // plays the sound soundID
+    virtual void playSound(int soundID) = 0;
+
+    // sets the text at the top of the screen
+    virtual void setGameStatText(std::string text) = 0;
+
+    // returns the current level, starting at 0
+    virtual unsigned int getLevel() const = 0;
+
+    // returns the number of lives the player has left
+    virtual unsigned int getLives() const = 0;
+
+    // takes away one of the player's lives
+    virtual void decLives() = 0;
+
+    // returns the game's score
+    virtual unsigned int getScore() const = 0;
+
+    // adds howMuch to the game's score
+    virtual void increaseScore(unsigned int howMuch) = 0;
+
+    // called when o joins the game, so the frontend can start drawing it
+    virtual void objAdded(obj* o) = 0;
+
+    // called right before o leaves the game and is destroyed, so the frontend can stop drawing it
+    virtual void objRemoved(obj* o) = 0;
+
+    // called when the Earth at (x, y) is dug out or cleared
+    virtual void earthRemoved(int x, int y) = 0;
+};
+
+#endif // GAMEFRONTEND_H_
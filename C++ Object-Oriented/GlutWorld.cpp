@@ -0,0 +1,206 @@
+#include "GlutWorld.h"
+#include <new>
+#include <time.h>
+#include <stdlib.h>
+using namespace std;
+
+// creates and returns pointer to new GlutWorld, which the GLUT controller drives like any GameWorld
+GameWorld* createStudentWorld(string assetDir)
+{
+    return new GlutWorld(assetDir);
+}
+
+// constructor, the StudentWorld sends everything it needs from outside of the game back to this adapter
+// a game played with GLUT is seeded from the clock so every game is different
+GlutWorld::GlutWorld(std::string assetDir)
+    : GameWorld(assetDir), seed(time(NULL)), world(this, seed)
+{
+    ticksRun = 0;
+    recorder = NULL;
+
+    // record the game if asked to
+    const char* path = getenv("TUNNELMAN_RECORD");
+    if (path != NULL && path[0] != '\0') {
+        recordPath = path;
+        recorder = new SessionLog(seed, getLives());
+    }
+}
+
+// destructor, cleanUp has already freed every sprite
+GlutWorld::~GlutWorld()
+{
+    if (recorder != NULL) {
+        recorder->save(recordPath);
+        delete recorder;
+    }
+}
+
+// fills the screen with Earth sprites, constructing each one in place in earthBlock
+// StudentWorld then hides the ones it clears while setting up the level
+int GlutWorld::init()
+{
+    for (int i = 0; i < 64; i++)
+        for (int j = 0; j < 60; j++) {
+            GraphObject* earth = new (earthAt(i, j)) GraphObject(TID_EARTH, i, j, GraphObject::right, 0.25, 3);
+            earth->setVisible(true);
+        }
+
+    int status = world.init();
+
+    syncSprites(); // catch anything the objs changed about themselves after they were added
+
+    return status;
+}
+
+// the sprites are only updated once per tick, after every obj has acted
+int GlutWorld::move()
+{
+    int status = world.move();
+
+    syncSprites();
+
+    ticksRun++;
+
+    // the recording always describes the game up to the end of the last tick
+    if (recorder != NULL)
+        recorder->changeEnd(ticksRun, getScore(), statText);
+
+    return status;
+}
+
+// StudentWorld frees every obj (and their sprites), then the Earth sprites are destroyed in place
+void GlutWorld::cleanUp()
+{
+    world.cleanUp();
+
+    for (int i = 0; i < 64; i++)
+        for (int j = 0; j < 60; j++)
+            earthAt(i, j)->~GraphObject();
+
+    // save after every level, so the recording survives the game being closed in the middle of the next one
+    if (recorder != NULL)
+        recorder->save(recordPath);
+}
+
+// returns true and sets value if a key was pressed
+// every key the world reads is recorded along with the tick it was read on
+bool GlutWorld::getKey(int& value)
+{
+    if (!GameWorld::getKey(value))
+        return false;
+
+    if (recorder != NULL)
+        recorder->recordKey(ticksRun, value);
+
+    return true;
+}
+
+// plays the sound soundID
+void GlutWorld::playSound(int soundID)
+{
+    GameWorld::playSound(soundID);
+}
+
+// sets the text at the top of the screen
+void GlutWorld::setGameStatText(std::string text)
+{
+    statText = text;
+    GameWorld::setGameStatText(text);
+}
+
+// returns the current level
+unsigned int GlutWorld::getLevel() const
+{
+    return GameWorld::getLevel();
+}
+
+// returns the number of lives left
+unsigned int GlutWorld::getLives() const
+{
+    return GameWorld::getLives();
+}
+
+// takes away one of the player's lives
+void GlutWorld::decLives()
+{
+    GameWorld::decLives();
+}
+
+// returns the game's score
+unsigned int GlutWorld::getScore() const
+{
+    return GameWorld::getScore();
+}
+
+// increases the game's score
+void GlutWorld::increaseScore(unsigned int howMuch)
+{
+    GameWorld::increaseScore(howMuch);
+}
+
+// makes a sprite that looks like o does right now
+void GlutWorld::objAdded(obj* o)
+{
+    GraphObject* sprite = new GraphObject(o->getID(), o->getX(), o->getY(), toGraphDirection(o->getDirection()), o->getSize(), o->getDepth());
+    sprite->setVisible(o->isVisible());
+
+    sprites[o] = sprite;
+}
+
+// o is about to be destroyed, so its sprite goes with it
+void GlutWorld::objRemoved(obj* o)
+{
+    std::map<obj*, GraphObject*>::iterator it = sprites.find(o);
+    if (it == sprites.end())
+        return;
+
+    delete it->second;
+    sprites.erase(it);
+}
+
+// hides the Earth at (x, y)
+void GlutWorld::earthRemoved(int x, int y)
+{
+    earthAt(x, y)->setVisible(false);
+}
+
+// returns the Earth sprite covering (x, y), which lives at index x * 60 + y of earthBlock
+GraphObject* GlutWorld::earthAt(int x, int y)
+{
+    return reinterpret_cast<GraphObject*>(earthBlock) + (x * 60 + y);
+}
+
+// only moves a sprite when its obj moved, so GraphObject can animate the step
+void GlutWorld::syncSprites()
+{
+    std::map<obj*, GraphObject*>::iterator it = sprites.begin();
+    while (it != sprites.end()) {
+        obj* o = it->first;
+        GraphObject* sprite = it->second;
+
+        if (sprite->getX() != o->getX() || sprite->getY() != o->getY())
+            sprite->moveTo(o->getX(), o->getY());
+
+        sprite->setDirection(toGraphDirection(o->getDirection()));
+        sprite->setVisible(o->isVisible());
+
+        it++;
+    }
+}
+
+// obj::Direction lists the directions in the same order, but they are matched by name to be safe
+GraphObject::Direction GlutWorld::toGraphDirection(obj::Direction dir)
+{
+    switch (dir) {
+    case obj::up:
+        return GraphObject::up;
+    case obj::down:
+        return GraphObject::down;
+    case obj::left:
+        return GraphObject::left;
+    case obj::right:
+        return GraphObject::right;
+    default:
+        return GraphObject::none;
+    }
+}
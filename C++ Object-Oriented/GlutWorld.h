@@ -0,0 +1,73 @@
+#ifndef GLUTWORLD_H_
+#define GLUTWORLD_H_
+
+#include "GameWorld.h"
+#include "GraphObject.h"
+#include "GameFrontend.h"
+#include "StudentWorld.h"
+#include "Replay.h"
+#include <string>
+#include <map>
+
+// adapter that lets the GLUT game controller run the headless StudentWorld
+// forwards input, sound, and the level / lives / score to GameWorld, and keeps one GraphObject sprite
+// for every obj and every Earth so the controller has something to draw
+// if TUNNELMAN_RECORD names a file, the game's seed and keys are saved there after every level, so it can be
+// played back headless with tools/replay
+class GlutWorld : public GameWorld, public GameFrontend {
+public:
+    // constructor
+    GlutWorld(std::string assetDir);
+
+    // virtual destructor, saves the recording if there is one
+    virtual ~GlutWorld();
+
+    // shows all of the Earth, then starts the level
+    virtual int init();
+
+    // runs one tick, then updates the sprites to match the objs
+    virtual int move();
+
+    // ends the level, frees the Earth sprites, and saves the recording if there is one
+    virtual void cleanUp();
+
+    // GameFrontend methods, forwarded to GameWorld
+    virtual bool getKey(int& value);
+    virtual void playSound(int soundID);
+    virtual void setGameStatText(std::string text);
+    virtual unsigned int getLevel() const;
+    virtual unsigned int getLives() const;
+    virtual void decLives();
+    virtual unsigned int getScore() const;
+    virtual void increaseScore(unsigned int howMuch);
+
+    // makes a sprite for o
+    virtual void objAdded(obj* o);
+
+    // frees the sprite for o
+    virtual void objRemoved(obj* o);
+
+    // hides the Earth sprite at (x, y)
+    virtual void earthRemoved(int x, int y);
+
+private:
+    uint64_t seed; // seed the world was built with
+    StudentWorld world; // the game itself
+    SessionLog* recorder; // the keys read so far, NULL if the game is not being recorded
+    std::string recordPath; // file the recording is saved to
+    std::string statText; // the last text at the top of the screen, kept for the recording
+    long ticksRun; // number of ticks run so far
+    std::map<obj*, GraphObject*> sprites; // the sprite drawn for each obj in game
+    alignas(GraphObject) unsigned char earthBlock[64 * 60 * sizeof(GraphObject)]; // storage for every Earth sprite, one per cell
+
+    // returns the Earth sprite that covers the cell (x, y)
+    GraphObject* earthAt(int x, int y);
+
+    // copies the position, direction, and visibility of every obj onto its sprite
+    void syncSprites();
+
+    // returns the GraphObject direction matching dir
+    static GraphObject::Direction toGraphDirection(obj::Direction dir);
+};
+
+#endif // GLUTWORLD_H_
@@ -0,0 +1,162 @@
+#include "HeadlessGame.h"
+#include "Replay.h"
+
+// constructor, no level is running until the first tick
+HeadlessGame::HeadlessGame(uint64_t seed, unsigned int startLives, int width, int height)
+    : world(this, seed, width, height)
+{
+    level = 0;
+    lives = startLives;
+    score = 0;
+    levelRunning = false;
+    ticksRun = 0;
+    recorder = NULL;
+}
+
+// destructor, frees the objs of the level that is still running
+HeadlessGame::~HeadlessGame()
+{
+    if (levelRunning)
+        world.cleanUp();
+}
+
+// adds key to the back of the queue
+void HeadlessGame::pushKey(int key)
+{
+    keys.push(key);
+}
+
+// keys read from now on go into log
+void HeadlessGame::setRecorder(SessionLog* log)
+{
+    recorder = log;
+}
+
+// follows the same steps as the GLUT controller: a death restarts the level, finishing it moves onto the next one
+int HeadlessGame::tick()
+{
+    // start the level if the last one ended
+    if (!levelRunning) {
+        world.init();
+        levelRunning = true;
+    }
+
+    int status = world.move();
+
+    // if the player died, end the level so it is started again on the next tick
+    if (status == GWSTATUS_PLAYER_DIED) {
+        world.cleanUp();
+        levelRunning = false;
+    }
+    // if the player found every barrel, end the level and move onto the next one
+    else if (status == GWSTATUS_FINISHED_LEVEL) {
+        world.cleanUp();
+        levelRunning = false;
+        level++;
+    }
+
+    ticksRun++;
+
+    // the log always describes the game up to the end of the last tick
+    if (recorder != NULL)
+        recorder->changeEnd(ticksRun, score, statText);
+
+    return status;
+}
+
+// stops early once the player runs out of lives
+long HeadlessGame::run(long maxTicks)
+{
+    long ticks = 0;
+
+    while (ticks < maxTicks && !isGameOver()) {
+        tick();
+        ticks++;
+    }
+
+    return ticks;
+}
+
+// returns true if the player is out of lives
+bool HeadlessGame::isGameOver() const
+{
+    return lives == 0;
+}
+
+// returns the text at the top of the screen
+std::string HeadlessGame::getGameStatText() const
+{
+    return statText;
+}
+
+// hands out the oldest queued key, if there is one
+bool HeadlessGame::getKey(int& value)
+{
+    if (keys.empty())
+        return false;
+
+    value = keys.front();
+    keys.pop();
+
+    if (recorder != NULL)
+        recorder->recordKey(ticksRun, value);
+
+    return true;
+}
+
+// there is no sound headless
+void HeadlessGame::playSound(int)
+{
+}
+
+// saves the text so it can be read back with getGameStatText
+void HeadlessGame::setGameStatText(std::string text)
+{
+    statText = text;
+}
+
+// returns the current level
+unsigned int HeadlessGame::getLevel() const
+{
+    return level;
+}
+
+// returns the number of lives left
+unsigned int HeadlessGame::getLives() const
+{
+    return lives;
+}
+
+// takes away one of the player's lives
+void HeadlessGame::decLives()
+{
+    if (lives > 0)
+        lives--;
+}
+
+// returns the game's score
+unsigned int HeadlessGame::getScore() const
+{
+    return score;
+}
+
+// increases the game's score
+void HeadlessGame::increaseScore(unsigned int howMuch)
+{
+    score += howMuch;
+}
+
+// there is nothing to draw headless
+void HeadlessGame::objAdded(obj*)
+{
+}
+
+// there is nothing to draw headless
+void HeadlessGame::objRemoved(obj*)
+{
+}
+
+// there is nothing to draw headless
+void HeadlessGame::earthRemoved(int, int)
+{
+}
@@ -0,0 +1,69 @@
+#ifndef HEADLESSGAME_H_
+#define HEADLESSGAME_H_
+
+#include "GameFrontend.h"
+#include "StudentWorld.h"
+#include <string>
+#include <queue>
+
+class SessionLog;
+
+// runs StudentWorld without GLUT, sound, or a keyboard, for benchmarks and batch simulation
+// keeps its own level, lives, and score, and moves between levels the same way the GLUT controller does
+class HeadlessGame : public GameFrontend {
+public:
+    // constructor, the game starts at level 0 with startLives lives on a width by height field
+    // the game is seeded with seed, so the same seed and keys always play out the same way
+    HeadlessGame(uint64_t seed, unsigned int startLives = 3, int width = 64, int height = 64);
+
+    // virtual destructor, ends the level that is running if there is one
+    virtual ~HeadlessGame();
+
+    // queues key to be handed to the player on a later tick, one key per tick
+    void pushKey(int key);
+
+    // records every key the player reads, and where the game has got to after each tick, into log
+    // log must outlive the game, or be replaced first. passing NULL stops recording
+    void setRecorder(SessionLog* log);
+
+    // runs one tick, starting a level first if one is not running
+    // returns the status from StudentWorld::move
+    int tick();
+
+    // runs ticks until the game is over or maxTicks ticks have run, returns the number of ticks run
+    long run(long maxTicks);
+
+    // returns true once the player has no lives left
+    bool isGameOver() const;
+
+    // returns the text StudentWorld last put at the top of the screen
+    std::string getGameStatText() const;
+
+    // GameFrontend methods
+    virtual bool getKey(int& value);
+    virtual void playSound(int soundID);
+    virtual void setGameStatText(std::string text);
+    virtual unsigned int getLevel() const;
+    virtual unsigned int getLives() const;
+    virtual void decLives();
+    virtual unsigned int getScore() const;
+    virtual void increaseScore(unsigned int howMuch);
+
+    // nothing is drawn, so these do nothing
+    virtual void objAdded(obj* o);
+    virtual void objRemoved(obj* o);
+    virtual void earthRemoved(int x, int y);
+
+private:
+    StudentWorld world; // the game itself
+    std::queue<int> keys; // keys waiting to be read by the player
+    std::string statText; // the last text at the top of the screen
+    unsigned int level; // current level
+    unsigned int lives; // lives left
+    unsigned int score; // game's score
+    bool levelRunning; // true if init has been called for the current level but cleanUp has not
+    long ticksRun; // number of ticks run so far
+    SessionLog* recorder; // where keys and the end of each tick are recorded, NULL if they are not
+};
+
+#endif // HEADLESSGAME_H_
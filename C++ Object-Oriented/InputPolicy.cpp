@@ -0,0 +1,68 @@
+#include "InputPolicy.h"
+#include "GameConstants.h"
+
+// the four direction keys, in the order RandomInput picks from
+static const int DIRECTION_KEYS[4] = { KEY_PRESS_LEFT, KEY_PRESS_RIGHT, KEY_PRESS_UP, KEY_PRESS_DOWN };
+
+// no key is ever pressed
+bool IdleInput::nextKey(int&)
+{
+    return false;
+}
+
+// the policy's seed is mixed so it does not draw the same numbers as a world seeded with the same value
+RandomInput::RandomInput(uint64_t seed)
+    : rng(seed ^ 0x5eedf00dcafe1234ULL)
+{
+    heading = DIRECTION_KEYS[rng.bounded(0, 3)];
+}
+
+// out of every 100 ticks, roughly 60 keep walking, 10 turn, 4 squirt, 1 uses sonar, 1 drops gold, and the rest are idle
+bool RandomInput::nextKey(int& key)
+{
+    int roll = rng.bounded(1, 100);
+
+    // keep walking the same way
+    if (roll <= 60) {
+        key = heading;
+        return true;
+    }
+
+    // turn to a new direction and take a step
+    if (roll <= 70) {
+        heading = DIRECTION_KEYS[rng.bounded(0, 3)];
+        key = heading;
+        return true;
+    }
+
+    // fire a squirt
+    if (roll <= 74) {
+        key = KEY_PRESS_SPACE;
+        return true;
+    }
+
+    // use a sonar charge
+    if (roll == 75) {
+        key = 'z';
+        return true;
+    }
+
+    // drop a gold nugget
+    if (roll == 76) {
+        key = KEY_PRESS_TAB;
+        return true;
+    }
+
+    return false; // stand still
+}
+
+// builds the policy asked for
+InputPolicy* makeInputPolicy(InputPolicy::Kind kind, uint64_t seed)
+{
+    switch (kind) {
+    case InputPolicy::RANDOM:
+        return new RandomInput(seed);
+    default:
+        return new IdleInput;
+    }
+}
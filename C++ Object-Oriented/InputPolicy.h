@@ -0,0 +1,47 @@
+#ifndef INPUTPOLICY_H_
+#define INPUTPOLICY_H_
+
+#include "Random.h"
+#include <stdint.h>
+
+// stands in for the keyboard when a game is run headless
+// asked once per tick for the key the player presses on that tick
+class InputPolicy {
+public:
+    // kinds of policy that makeInputPolicy can build
+    enum Kind { IDLE, RANDOM };
+
+    // virtual destructor
+    virtual ~InputPolicy() {}
+
+    // returns true and sets key if a key is pressed this tick
+    virtual bool nextKey(int& key) = 0;
+};
+
+// never presses a key, so only the protesters and falling Boulders act
+class IdleInput : public InputPolicy {
+public:
+    // always returns false
+    virtual bool nextKey(int& key);
+};
+
+// wanders around digging, now and then firing squirts, using sonar, and dropping gold
+// draws from its own generator, so the same seed always presses the same keys
+class RandomInput : public InputPolicy {
+public:
+    // constructor, seeds the policy's generator
+    RandomInput(uint64_t seed);
+
+    // presses a key on most ticks, mostly in the direction it has been heading
+    virtual bool nextKey(int& key);
+
+private:
+    Random rng; // generator for the policy's choices
+    int heading; // direction key the policy has been holding
+};
+
+// returns a new policy of the given kind, seeded with seed if it uses random numbers
+// the caller is responsible for deleting it
+InputPolicy* makeInputPolicy(InputPolicy::Kind kind, uint64_t seed);
+
+#endif // INPUTPOLICY_H_
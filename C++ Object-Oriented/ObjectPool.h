@@ -0,0 +1,76 @@
+#ifndef OBJECTPOOL_H_
+#define OBJECTPOOL_H_
+
+#include <vector>
+#include <new>
+#include <utility>
+
+// pool of recycled slots for objects of type T that are created and destroyed often (e.g. Squirts)
+// slots are handed out from a free list and returned to it when the object is destroyed, so once the pool
+// has grown to the most objects alive at once, creating an object never allocates memory
+template <class T>
+class ObjectPool {
+public:
+    // number of slots added to the pool each time it runs out
+    static const int CHUNK_SIZE = 16;
+
+    // constructor, starts with no slots
+    ObjectPool()
+    {
+    }
+
+    // destructor, frees every chunk of slots
+    // every object made by the pool must already have been destroyed
+    ~ObjectPool()
+    {
+        for (size_t i = 0; i < chunks.size(); i++)
+            delete chunks[i];
+    }
+
+    // constructs a T in a free slot, passing args to its constructor, and returns a pointer to it
+    template <class... Args>
+    T* create(Args&&... args)
+    {
+        // if every slot is taken, add a new chunk of slots to the free list
+        if (freeSlots.empty())
+            grow();
+
+        T* slot = freeSlots.back();
+        freeSlots.pop_back();
+
+        return new (slot) T(std::forward<Args>(args)...);
+    }
+
+    // destroys item in place and returns its slot to the free list
+    void destroy(T* item)
+    {
+        item->~T();
+        freeSlots.push_back(item);
+    }
+
+private:
+    // struct for a block of raw storage holding CHUNK_SIZE objects
+    struct chunk {
+        alignas(T) unsigned char slots[CHUNK_SIZE * sizeof(T)];
+    };
+
+    // copying a pool would free its chunks twice, so it is not allowed
+    ObjectPool(const ObjectPool&);
+    ObjectPool& operator=(const ObjectPool&);
+
+    std::vector<chunk*> chunks; // every block of storage owned by the pool
+    std::vector<T*> freeSlots; // slots that do not hold an object
+
+    // allocates a new chunk and puts all of its slots on the free list
+    void grow()
+    {
+        chunk* block = new chunk;
+        chunks.push_back(block);
+
+        // push the slots in reverse so they are handed out from the start of the chunk
+        for (int i = CHUNK_SIZE - 1; i >= 0; i--)
+            freeSlots.push_back(reinterpret_cast<T*>(block->slots) + i);
+    }
+};
+
+#endif // OBJECTPOOL_H_
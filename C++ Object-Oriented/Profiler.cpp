@@ -0,0 +1,151 @@
+#include "Profiler.h"
+
+// everything here is only built when profiling is turned on
+#ifdef TUNNELMAN_PROFILE
+
+#include <stdlib.h>
+#include <string.h>
+
+// starts the clock
+Profiler::scope::scope(Profiler& profilerIn, Phase phaseIn)
+    : profiler(profilerIn), phase(phaseIn), start(std::chrono::steady_clock::now())
+{
+}
+
+// adds the elapsed time to the phase of the current tick
+Profiler::scope::~scope()
+{
+    profiler.current.phaseNs[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// clears the current record so work done between ticks (e.g. while setting up the level) is not counted
+Profiler::tickScope::tickScope(Profiler& profilerIn)
+    : profiler(profilerIn)
+{
+    tickRecord& current = profiler.current;
+
+    current.tick = long(profiler.ticks.size());
+    current.totalNs = 0;
+    for (int i = 0; i < PHASES; i++)
+        current.phaseNs[i] = 0;
+    for (int i = 0; i < COUNTERS; i++)
+        current.counts[i] = 0;
+
+    start = std::chrono::steady_clock::now();
+}
+
+// saves the finished record
+Profiler::tickScope::~tickScope()
+{
+    profiler.current.totalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    profiler.ticks.push_back(profiler.current);
+}
+
+// picks up TUNNELMAN_PROFILE_OUT and TUNNELMAN_PROFILE_FORMAT, if they are set
+Profiler::Profiler(uint64_t seedIn)
+{
+    seed = seedIn;
+
+    const char* prefix = getenv("TUNNELMAN_PROFILE_OUT");
+    const char* format = getenv("TUNNELMAN_PROFILE_FORMAT");
+
+    outPrefix = (prefix != NULL) ? prefix : "";
+    outJSON = (format != NULL && strcmp(format, "json") == 0);
+    levelsWritten = 0;
+
+    current = tickRecord();
+}
+
+// changes where levels are written
+void Profiler::setOutput(std::string prefix, bool json)
+{
+    outPrefix = prefix;
+    outJSON = json;
+}
+
+// adds to the counter of the current tick
+void Profiler::count(Counter counter, long n)
+{
+    current.counts[counter] += n;
+}
+
+// writes the level to its own file, if there is anywhere to write it
+void Profiler::endLevel(unsigned int level)
+{
+    if (!outPrefix.empty() && !ticks.empty()) {
+        std::string name = outPrefix + "-s" + std::to_string(seed) + "-" + std::to_string(levelsWritten) + "-level" + std::to_string(level) +
+            (outJSON ? ".json" : ".csv");
+
+        FILE* out = fopen(name.c_str(), "w");
+        if (out != NULL) {
+            if (outJSON)
+                writeJSON(ticks, level, out);
+            else
+                writeCSV(ticks, level, out);
+            fclose(out);
+        }
+
+        levelsWritten++;
+    }
+
+    ticks.clear();
+}
+
+// returns the ticks of the level so far
+const std::vector<Profiler::tickRecord>& Profiler::getTicks() const
+{
+    return ticks;
+}
+
+// one header row, then one row per tick
+void Profiler::writeCSV(const std::vector<tickRecord>& ticks, unsigned int level, FILE* out)
+{
+    fprintf(out, "level,tick,total_ns");
+    for (int i = 0; i < PHASES; i++)
+        fprintf(out, ",%s_ns", phaseName(Phase(i)));
+    for (int i = 0; i < COUNTERS; i++)
+        fprintf(out, ",%s", counterName(Counter(i)));
+    fprintf(out, "\n");
+
+    for (size_t t = 0; t < ticks.size(); t++) {
+        fprintf(out, "%u,%ld,%lld", level, ticks[t].tick, ticks[t].totalNs);
+        for (int i = 0; i < PHASES; i++)
+            fprintf(out, ",%lld", ticks[t].phaseNs[i]);
+        for (int i = 0; i < COUNTERS; i++)
+            fprintf(out, ",%ld", ticks[t].counts[i]);
+        fprintf(out, "\n");
+    }
+}
+
+// one object for the level holding an array with one object per tick
+void Profiler::writeJSON(const std::vector<tickRecord>& ticks, unsigned int level, FILE* out)
+{
+    fprintf(out, "{\"level\": %u, \"ticks\": [", level);
+
+    for (size_t t = 0; t < ticks.size(); t++) {
+        fprintf(out, "%s\n  {\"tick\": %ld, \"total_ns\": %lld", (t == 0) ? "" : ",", ticks[t].tick, ticks[t].totalNs);
+        for (int i = 0; i < PHASES; i++)
+            fprintf(out, ", \"%s_ns\": %lld", phaseName(Phase(i)), ticks[t].phaseNs[i]);
+        for (int i = 0; i < COUNTERS; i++)
+            fprintf(out, ", \"%s\": %ld", counterName(Counter(i)), ticks[t].counts[i]);
+        fprintf(out, "}");
+    }
+
+    fprintf(out, "\n]}\n");
+}
+
+// names used for the columns / keys of each phase
+const char* Profiler::phaseName(Phase phase)
+{
+    static const char* const names[PHASES] = { "text", "player", "boulders", "protesters", "goods", "squirts", "sweep", "spawn", "paths" };
+    return names[phase];
+}
+
+// names used for the columns / keys of each counter
+const char* Profiler::counterName(Counter counter)
+{
+    static const char* const names[COUNTERS] = { "path_searches", "nodes_expanded" };
+    return names[counter];
+}
+
+#endif // TUNNELMAN_PROFILE
@@ -0,0 +1,128 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+// optional per-tick profiler for StudentWorld::move
+// the PROFILE_ macros below are the only way the game touches the profiler, and unless TUNNELMAN_PROFILE
+// is defined they expand to nothing, StudentWorld has no profiler member, and Profiler.cpp is empty
+//
+// when it is on, every tick records the wall time of each phase of move, plus how many distance field
+// searches ran and how many positions they expanded. the ticks of a level are written out as CSV or JSON
+// when the level ends, to <prefix>-s<seed>-<n>-level<L>.csv (or .json), where prefix comes from setOutput or the
+// TUNNELMAN_PROFILE_OUT environment variable, seed is the world's seed, and n counts the levels this profiler has
+// written. the seed keeps the files of worlds running side by side in one batch apart, since they share the prefix.
+// TUNNELMAN_PROFILE_FORMAT=json picks JSON. nothing is written if no prefix is set.
+
+#ifdef TUNNELMAN_PROFILE
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+class Profiler {
+public:
+    // the parts of a tick that are timed
+    // PATHS runs inside the other phases (mostly PROTESTERS), so its time is also counted in theirs
+    enum Phase { TEXT, PLAYER, BOULDERS, PROTESTERS, GOODS, SQUIRTS, SWEEP, SPAWN, PATHS, PHASES };
+
+    // the events that are counted
+    enum Counter { PATH_SEARCHES, NODES_EXPANDED, COUNTERS };
+
+    // struct holding everything recorded for one tick
+    struct tickRecord {
+        long tick; // tick number within the level, starting at 0
+        long long totalNs; // wall time of the whole tick
+        long long phaseNs[PHASES]; // wall time of each phase
+        long counts[COUNTERS]; // number of each event
+    };
+
+    // times one phase from its construction to its destruction
+    class scope {
+    public:
+        // starts the clock for phase
+        scope(Profiler& profilerIn, Phase phaseIn);
+
+        // adds the time since construction to the phase
+        ~scope();
+
+    private:
+        Profiler& profiler; // profiler to add the time to
+        Phase phase; // phase being timed
+        std::chrono::steady_clock::time_point start; // when the scope began
+    };
+
+    // times one whole tick from its construction to its destruction, so early returns are still recorded
+    class tickScope {
+    public:
+        // starts a new tick record
+        tickScope(Profiler& profilerIn);
+
+        // finishes the tick record
+        ~tickScope();
+
+    private:
+        Profiler& profiler; // profiler recording the tick
+        std::chrono::steady_clock::time_point start; // when the tick began
+    };
+
+    // constructor, reads the output settings from the environment
+    // seed is the seed of the world being profiled, which goes in the name of every file written
+    Profiler(uint64_t seedIn);
+
+    // sets where levels are written, and whether as JSON (true) or CSV (false)
+    // an empty prefix turns writing off
+    void setOutput(std::string prefix, bool json);
+
+    // adds n to counter for the current tick
+    void count(Counter counter, long n);
+
+    // writes the ticks recorded this level for level, then starts over for the next level
+    void endLevel(unsigned int level);
+
+    // returns the ticks recorded so far this level
+    const std::vector<tickRecord>& getTicks() const;
+
+    // writes ticks as CSV or JSON to out
+    static void writeCSV(const std::vector<tickRecord>& ticks, unsigned int level, FILE* out);
+    static void writeJSON(const std::vector<tickRecord>& ticks, unsigned int level, FILE* out);
+
+    // returns the name of phase or counter as used in the output
+    static const char* phaseName(Phase phase);
+    static const char* counterName(Counter counter);
+
+private:
+    std::vector<tickRecord> ticks; // every tick recorded this level
+    tickRecord current; // the tick being recorded
+    std::string outPrefix; // start of the file name for each level, empty if nothing is written
+    bool outJSON; // true to write JSON, false to write CSV
+    int levelsWritten; // number of levels written, used to keep file names apart
+    uint64_t seed; // seed of the world being profiled, used to keep the file names of different worlds apart
+};
+
+// helpers so each PROFILE_SCOPE gets its own variable name
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// records the enclosing block as one tick
+#define PROFILE_TICK(profiler) Profiler::tickScope PROFILE_CONCAT(profileTick, __LINE__)(profiler)
+
+// adds the time spent in the enclosing block to phase
+#define PROFILE_SCOPE(profiler, phase) Profiler::scope PROFILE_CONCAT(profileScope, __LINE__)((profiler), Profiler::phase)
+
+// adds n to counter
+#define PROFILE_COUNT(profiler, counter, n) (profiler).count(Profiler::counter, (n))
+
+// writes out the level that just ended
+#define PROFILE_END_LEVEL(profiler, level) (profiler).endLevel(level)
+
+#else
+
+#define PROFILE_TICK(profiler)
+#define PROFILE_SCOPE(profiler, phase)
+#define PROFILE_COUNT(profiler, counter, n)
+#define PROFILE_END_LEVEL(profiler, level)
+
+#endif // TUNNELMAN_PROFILE
+
+#endif // PROFILER_H_
@@ -0,0 +1,64 @@
+#include "Random.h"
+
+// rotates x left by k bits
+static uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// constructor
+Random::Random(uint64_t seed)
+{
+    this->seed(seed);
+}
+
+// spreads the seed over the state with splitmix64, so nearby seeds still give unrelated sequences
+void Random::seed(uint64_t seed)
+{
+    for (int i = 0; i < 4; i++) {
+        seed += 0x9e3779b97f4a7c15ULL;
+
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        state[i] = z ^ (z >> 31);
+    }
+}
+
+// one step of xoshiro256**
+uint64_t Random::next()
+{
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+
+    return result;
+}
+
+// scales 32 random bits onto the range with a multiply instead of %, and throws away the few
+// draws that would make the low numbers more likely than the high ones
+int Random::bounded(int min, int max)
+{
+    uint32_t range = uint32_t(max - min) + 1;
+
+    uint64_t product = uint64_t(uint32_t(next() >> 32)) * range;
+    uint32_t low = uint32_t(product);
+
+    // only draws that land in the leftover part of the last lap around the range are biased
+    if (low < range) {
+        uint32_t threshold = uint32_t(-range) % range;
+        while (low < threshold) {
+            product = uint64_t(uint32_t(next() >> 32)) * range;
+            low = uint32_t(product);
+        }
+    }
+
+    return min + int(product >> 32);
+}
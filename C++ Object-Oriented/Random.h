@@ -0,0 +1,26 @@
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <stdint.h>
+
+// small, fast random number generator (xoshiro256**) owned by a single StudentWorld
+// the same seed always gives the same numbers, and two generators never share any state
+class Random {
+public:
+    // constructor, starts the sequence for seed
+    Random(uint64_t seed = 0);
+
+    // restarts the sequence for seed
+    void seed(uint64_t seed);
+
+    // returns the next 64 random bits
+    uint64_t next();
+
+    // returns a random number from min to max, inclusive, with every number equally likely
+    int bounded(int min, int max);
+
+private:
+    uint64_t state[4]; // the generator's 256 bits of state, never all zero
+};
+
+#endif // RANDOM_H_
@@ -0,0 +1,312 @@
+#include "Replay.h"
+#include "HeadlessGame.h"
+#include "WorldSize.h"
+#include <stdio.h>
+#include <chrono>
+
+// the first bytes of every log, followed by the format version
+// version 1 logs have no field size, and were always played on the game's own 64 by 64 field
+static const char LOG_MAGIC[4] = { 'T', 'M', 'R', 'L' };
+static const unsigned char LOG_VERSION = 2;
+
+// appends value to out, seven bits per byte with the high bit set on every byte but the last
+static void putVarint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+// reads a value written by putVarint from in at pos, moving pos past it
+// returns false if in ends first or the value is too long
+static bool getVarint(const std::string& in, size_t& pos, uint64_t& value)
+{
+    value = 0;
+
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size())
+            return false;
+
+        unsigned char byte = (unsigned char)in[pos++];
+        value |= uint64_t(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+// constructor, nothing recorded
+SessionLog::SessionLog()
+{
+    seed = 0;
+    startLives = 0;
+    width = 64;
+    height = 64;
+    ticks = 0;
+    score = 0;
+}
+
+// constructor, nothing recorded yet
+SessionLog::SessionLog(uint64_t seed, unsigned int startLives, int width, int height)
+{
+    this->seed = seed;
+    this->startLives = startLives;
+    this->width = width;
+    this->height = height;
+    ticks = 0;
+    score = 0;
+}
+
+// adds the key to the end of the log
+void SessionLog::recordKey(long tick, int key)
+{
+    keyPress press;
+    press.tick = tick;
+    press.key = key;
+    keys.push_back(press);
+}
+
+// updates where the game has got to
+void SessionLog::changeEnd(long ticks, unsigned int score, std::string statText)
+{
+    this->ticks = ticks;
+    this->score = score;
+    this->statText = statText;
+}
+
+// builds the whole file in memory, then writes it in one go
+bool SessionLog::save(std::string path) const
+{
+    std::string out(LOG_MAGIC, 4);
+    out.push_back(char(LOG_VERSION));
+
+    // the seed is stored as 8 bytes, lowest first, since it is usually large
+    for (int i = 0; i < 8; i++)
+        out.push_back(char((seed >> (8 * i)) & 0xff));
+
+    putVarint(out, startLives);
+    putVarint(out, uint64_t(width));
+    putVarint(out, uint64_t(height));
+    putVarint(out, uint64_t(ticks));
+    putVarint(out, score);
+    putVarint(out, statText.size());
+    out += statText;
+
+    // each key is stored as the gap since the tick of the last one, then the key
+    putVarint(out, keys.size());
+    long lastTick = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        putVarint(out, uint64_t(keys[i].tick - lastTick));
+        putVarint(out, uint32_t(keys[i].key));
+        lastTick = keys[i].tick;
+    }
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == NULL)
+        return false;
+
+    bool written = fwrite(out.data(), 1, out.size(), file) == out.size();
+    return (fclose(file) == 0) && written;
+}
+
+// reads the whole file, then checks and decodes it field by field
+bool SessionLog::load(std::string path)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == NULL)
+        return false;
+
+    std::string in;
+    char buffer[4096];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        in.append(buffer, got);
+    fclose(file);
+
+    // check the magic and version
+    if (in.size() < 13 || in.compare(0, 4, LOG_MAGIC, 4) != 0)
+        return false;
+
+    unsigned char version = (unsigned char)in[4];
+    if (version < 1 || version > LOG_VERSION)
+        return false;
+
+    uint64_t newSeed = 0;
+    for (int i = 0; i < 8; i++)
+        newSeed |= uint64_t((unsigned char)in[5 + i]) << (8 * i);
+
+    size_t pos = 13;
+    uint64_t newLives, newTicks, newScore, textSize, keyCount;
+    uint64_t newWidth = 64, newHeight = 64;
+    if (!getVarint(in, pos, newLives))
+        return false;
+    if (version >= 2 && (!getVarint(in, pos, newWidth) || !getVarint(in, pos, newHeight)))
+        return false;
+
+    // a size no build can play would reach StudentWorld, so a corrupt size is rejected here like any other corrupt field
+    // a size only the dynamic build plays is still read, so the replay tool can say which build it needs
+    if (newWidth < uint64_t(MIN_WORLD_WIDTH) || newWidth > uint64_t(MAX_WORLD_SIZE) || newHeight < uint64_t(MIN_WORLD_HEIGHT) ||
+        newHeight > uint64_t(MAX_WORLD_SIZE))
+        return false;
+    if (!getVarint(in, pos, newTicks) || !getVarint(in, pos, newScore) || !getVarint(in, pos, textSize))
+        return false;
+    if (textSize > in.size() - pos)
+        return false;
+
+    std::string newText = in.substr(pos, size_t(textSize));
+    pos += size_t(textSize);
+
+    if (!getVarint(in, pos, keyCount))
+        return false;
+
+    // every key takes at least two bytes, which also stops a corrupt count from reserving too much
+    if (keyCount > (in.size() - pos) / 2)
+        return false;
+
+    std::vector<keyPress> newKeys;
+    newKeys.reserve(size_t(keyCount));
+    long lastTick = 0;
+    for (uint64_t i = 0; i < keyCount; i++) {
+        uint64_t gap, key;
+        if (!getVarint(in, pos, gap) || !getVarint(in, pos, key))
+            return false;
+
+        keyPress press;
+        press.tick = lastTick + long(gap);
+        press.key = int(uint32_t(key));
+        newKeys.push_back(press);
+        lastTick = press.tick;
+    }
+
+    // only replace the log once the whole file has been read
+    seed = newSeed;
+    startLives = unsigned(newLives);
+    width = int(newWidth);
+    height = int(newHeight);
+    ticks = long(newTicks);
+    score = unsigned(newScore);
+    statText = newText;
+    keys.swap(newKeys);
+
+    return true;
+}
+
+// returns the game's seed
+uint64_t SessionLog::getSeed() const
+{
+    return seed;
+}
+
+// returns the lives the player started with
+unsigned int SessionLog::getStartLives() const
+{
+    return startLives;
+}
+
+// returns the width of the field
+int SessionLog::getWidth() const
+{
+    return width;
+}
+
+// returns the height of the field
+int SessionLog::getHeight() const
+{
+    return height;
+}
+
+// returns the number of ticks played
+long SessionLog::getTicks() const
+{
+    return ticks;
+}
+
+// returns the score after the last tick
+unsigned int SessionLog::getScore() const
+{
+    return score;
+}
+
+// returns the text at the top of the screen after the last tick
+std::string SessionLog::getStatText() const
+{
+    return statText;
+}
+
+// returns the number of keys read
+size_t SessionLog::getKeyCount() const
+{
+    return keys.size();
+}
+
+// returns the tick key i was read on
+long SessionLog::getKeyTick(size_t i) const
+{
+    return keys[i].tick;
+}
+
+// returns key i
+int SessionLog::getKey(size_t i) const
+{
+    return keys[i].key;
+}
+
+// constructor, starts at the first tick
+ReplayInput::ReplayInput(const SessionLog& logIn)
+    : log(logIn)
+{
+    tick = 0;
+    next = 0;
+}
+
+// called once per tick, so the tick count stays in step with the game
+bool ReplayInput::nextKey(int& key)
+{
+    bool pressed = false;
+
+    if (next < log.getKeyCount() && log.getKeyTick(next) == tick) {
+        key = log.getKey(next);
+        next++;
+        pressed = true;
+    }
+
+    tick++;
+
+    return pressed;
+}
+
+// the world is built from the logged seed, and each logged key is queued just before the tick that reads it
+replayReport replaySession(const SessionLog& log)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    HeadlessGame game(log.getSeed(), log.getStartLives(), log.getWidth(), log.getHeight());
+    ReplayInput input(log);
+
+    long ticks = 0;
+    while (ticks < log.getTicks()) {
+        int key;
+        if (input.nextKey(key))
+            game.pushKey(key);
+
+        game.tick();
+        ticks++;
+    }
+
+    // record the results
+    replayReport report;
+    report.session.seed = log.getSeed();
+    report.session.score = game.getScore();
+    report.session.lives = game.getLives();
+    report.session.level = game.getLevel();
+    report.session.ticks = ticks;
+    report.session.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.statText = game.getGameStatText();
+    report.matches = (report.session.score == log.getScore() && report.statText == log.getStatText());
+
+    return report;
+}
@@ -0,0 +1,97 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "InputPolicy.h"
+#include "BatchRunner.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// everything needed to play a game over again: the seed, the starting lives, the size of the field, and every key the player read
+// along with the tick it was read on. the score and top-of-screen text after the last tick are kept too,
+// so a replay can check that it ended up in the same place
+//
+// saved as a small binary file. after a header holding the seed and the end of the game, each key is stored
+// as the number of ticks since the last key followed by the key, both as variable-length integers, so the
+// long runs of ticks where nothing is pressed take no space at all
+class SessionLog {
+public:
+    // constructor, an empty log to be filled by load
+    SessionLog();
+
+    // constructor, an empty log for a game seeded with seed that starts with startLives lives on a width by height field
+    SessionLog(uint64_t seed, unsigned int startLives, int width = 64, int height = 64);
+
+    // records that the player read key on tick (counting from 0), ticks must be recorded in order
+    void recordKey(long tick, int key);
+
+    // records that the game has now run ticks ticks, and its score and top-of-screen text after the last one
+    void changeEnd(long ticks, unsigned int score, std::string statText);
+
+    // writes the log to path, returns false if the file could not be written
+    bool save(std::string path) const;
+
+    // replaces the log with the one at path, returns false if the file could not be read or is not a log
+    bool load(std::string path);
+
+    // returns the game's seed and starting lives
+    uint64_t getSeed() const;
+    unsigned int getStartLives() const;
+
+    // returns the size of the field the game was played on
+    int getWidth() const;
+    int getHeight() const;
+
+    // returns the number of ticks played, and the score and text after the last one
+    long getTicks() const;
+    unsigned int getScore() const;
+    std::string getStatText() const;
+
+    // returns the number of keys read, and the tick and value of key i
+    size_t getKeyCount() const;
+    long getKeyTick(size_t i) const;
+    int getKey(size_t i) const;
+
+private:
+    // struct for one key the player read
+    struct keyPress {
+        long tick; // tick the key was read on
+        int key; // the key
+    };
+
+    uint64_t seed; // seed the world was built with
+    unsigned int startLives; // lives the player started with
+    int width; // width of the field
+    int height; // height of the field, including the top band
+    long ticks; // ticks played so far
+    unsigned int score; // score after the last tick
+    std::string statText; // text at the top of the screen after the last tick
+    std::vector<keyPress> keys; // every key read, in order
+};
+
+// presses the keys of a SessionLog on the ticks they were first read on
+class ReplayInput : public InputPolicy {
+public:
+    // constructor, log must outlive the ReplayInput
+    ReplayInput(const SessionLog& log);
+
+    // returns the key the log has for this tick, if there is one
+    virtual bool nextKey(int& key);
+
+private:
+    const SessionLog& log; // the keys being replayed
+    long tick; // tick the next call is for
+    size_t next; // index of the next key in log
+};
+
+// struct holding the results of replaySession
+struct replayReport {
+    sessionReport session; // how the replayed game went
+    std::string statText; // text at the top of the screen after the last tick
+    bool matches; // true if the score and text match the ones in the log
+};
+
+// plays the game in log headless, as fast as it will run, for as many ticks as were recorded
+replayReport replaySession(const SessionLog& log);
+
+#endif // REPLAY_H_
@@ -0,0 +1,113 @@
+#ifndef SPATIALGRID_H_
+#define SPATIALGRID_H_
+
+#include <vector>
+#include <algorithm>
+
+// uniform grid of 8x8 buckets over the screen, used to find the objects near a point
+// without walking every object in the game
+// objects are filed by their bottom left corner. coordinates off the screen (e.g. a Squirt fired off the edge)
+// are clamped into the edge buckets, so every object is always in exactly one bucket
+template <class T>
+class SpatialGrid {
+public:
+    // number of units covered by each side of a bucket
+    static const int BUCKET_SIZE = 8;
+
+    // constructor, covers a width by height screen
+    SpatialGrid(int width = 64, int height = 64)
+    {
+        resize(width, height);
+    }
+
+    // empties the grid and makes it cover a width by height screen
+    void resize(int width, int height)
+    {
+        bucketsX = (width + BUCKET_SIZE - 1) / BUCKET_SIZE;
+        bucketsY = (height + BUCKET_SIZE - 1) / BUCKET_SIZE;
+
+        buckets.clear();
+        buckets.resize(size_t(bucketsX) * bucketsY);
+    }
+
+    // adds item to the bucket covering (x, y)
+    void insert(T* item, int x, int y)
+    {
+        buckets[bucketAt(x, y)].push_back(item);
+    }
+
+    // removes item from the bucket covering (x, y)
+    void remove(T* item, int x, int y)
+    {
+        std::vector<T*>& bucket = buckets[bucketAt(x, y)];
+
+        // swap the item with the last one in the bucket so it can be popped off
+        typename std::vector<T*>::iterator it = std::find(bucket.begin(), bucket.end(), item);
+        if (it != bucket.end()) {
+            *it = bucket.back();
+            bucket.pop_back();
+        }
+    }
+
+    // moves item from the bucket covering (oldX, oldY) to the one covering (newX, newY), if they differ
+    void move(T* item, int oldX, int oldY, int newX, int newY)
+    {
+        if (bucketAt(oldX, oldY) == bucketAt(newX, newY))
+            return;
+
+        remove(item, oldX, oldY);
+        insert(item, newX, newY);
+    }
+
+    // empties every bucket
+    void clear()
+    {
+        for (size_t i = 0; i < buckets.size(); i++)
+            buckets[i].clear();
+    }
+
+    // calls visit(item) for every item in a bucket that overlaps the square of radius r around (x, y)
+    // the caller is responsible for checking the exact distance
+    // if visit returns true the search stops early and forEachCandidate returns true
+    template <class Visitor>
+    bool forEachCandidate(int x, int y, int r, Visitor visit) const
+    {
+        int loX = bucketOf(x - r, bucketsX);
+        int hiX = bucketOf(x + r, bucketsX);
+        int loY = bucketOf(y - r, bucketsY);
+        int hiY = bucketOf(y + r, bucketsY);
+
+        for (int i = loX; i <= hiX; i++)
+            for (int j = loY; j <= hiY; j++) {
+                const std::vector<T*>& bucket = buckets[size_t(i) * bucketsY + j];
+                for (size_t k = 0; k < bucket.size(); k++)
+                    if (visit(bucket[k]))
+                        return true;
+            }
+
+        return false;
+    }
+
+private:
+    int bucketsX; // number of buckets across the grid
+    int bucketsY; // number of buckets up the grid
+    std::vector<std::vector<T*> > buckets; // items in each bucket, indexed by (x / 8) * bucketsY + y / 8
+
+    // returns the bucket index along one axis of count buckets for the coordinate c, clamped to the grid
+    static int bucketOf(int c, int count)
+    {
+        if (c < 0)
+            return 0;
+        if (c / BUCKET_SIZE >= count)
+            return count - 1;
+        return c / BUCKET_SIZE;
+    }
+
+    // returns the index in buckets of the bucket covering (x, y)
+    size_t bucketAt(int x, int y) const
+    {
+        return size_t(bucketOf(x, bucketsX)) * bucketsY + bucketOf(y, bucketsY);
+    }
+};
+
+#endif // SPATIALGRID_H_
@@ -1,21 +1,44 @@
 #include "StudentWorld.h"
 #include <math.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <stdexcept>
 using namespace std;
 
-// creates and returns pointer to new StudentWorld
-GameWorld* createStudentWorld(string assetDir)
+// constructor, only saves the frontend and seeds the generator since init sets up each level
+// the generator is not reseeded between levels, so a whole game follows from the one seed
+// the terrain, spatial grids, and distance fields are sized once here, since the field keeps its size for the whole game
+StudentWorld::StudentWorld(GameFrontend* frontendIn, uint64_t seed, int width, int height)
+    : rng(seed),
+#ifdef TUNNELMAN_PROFILE
+      profiler(seed),
+#endif
+      terrain(checkSize(width, height), height)
 {
-    return new StudentWorld(assetDir); // reutn
+    frontend = frontendIn;
+
+    protesterGrid.resize(getWidth(), getHeight());
+    goodsGrid.resize(getWidth(), getHeight());
+    exitField.dist.resize(getWidth(), getHeight());
+    playerField.dist.resize(getWidth(), getHeight());
+
+    // a full search queues every position at most once, so this is usually all the room the queue ever needs
+    frontier.reserve(size_t(getMaxX() + 1) * (getMaxY() + 1));
+
+    // neither field holds anything yet, every position starts with a stamp no build will use
+    distField::entry blank = { -1, 0 };
+    terrainVersion = 1;
+    exitField.dist.fill(blank);
+    exitField.stamp = 0;
+    exitField.version = 0;
+    exitField.offset = 0;
+    playerField.dist.fill(blank);
+    playerField.stamp = 0;
+    playerField.version = 0;
+    playerField.offset = 0;
 }
 
-// constructor, leave blank
-StudentWorld::StudentWorld(std::string assetDir)
-    : GameWorld(assetDir)
-{
-}
-
-// destructor, will not be called
-// prof says must be empty on piazza
+// destructor, cleanUp has already freed every obj
 StudentWorld::~StudentWorld()
 {
 }
@@ -23,48 +46,47 @@ StudentWorld::~StudentWorld()
 // called at start of program, but not allowed to call myself
 int StudentWorld::init()
 {
-    srand(time(NULL)); // for use in randomly generating positions
-
     goodSpawn = getLevel() * 25 + 300; // 1 in goodSpawn chance of a good spawning
 
-    protesterCount = 0; // record that there are 0 protesters on the field
     protesterCountdown = 0; // generate a new protester on the next (first) tick of the game
 
+    chaseRange = 16 + getLevel() * 2; // hardcore protesters track the player from further away on later levels
+
     // number of oil barrels to be collected and to be generated
     int L = (2 + getLevel() < 21) ? 2 + getLevel() : 21;
 
-    player = new TunnelMan(this, L); // pointer to new TunnelMan object
+    player = new TunnelMan(this, L); // pointer to new TunnelMan object, kept apart from the other objs
+    frontend->objAdded(player);
 
-    actors.push_back(player); // places player in container of actors
+    // fills the hash table with Earth at each location
+    // the frontend starts every level with all of the Earth showing
+    terrain.fill();
 
-    // fills the screen with Earth and places the Earth in the container of actors
-    // also sets the hash table to contain Earth at each location
-    for (int i = 0; i < 64; i++) {
-        for (int j = 0; j < 60; j++) {
-            pixelArr[i][j] = new pixel(i, j, this, TID_EARTH);
+    // the fields from the last level no longer match, so the exit field is built the first time a protester leaves
+    // and the player field the first time a hardcore protester looks for the player
+    terrainClosed(0, 0, getWidth(), getHeight());
 
-            // leave a center channel empty by clearing the hash table in this location
-            if (30 <= i && i <= 33 && j > 3) {
-                setEarthInvis(i, j);
-            }
-        }
-    }
+    // left column of the center channel, 30 in the game's own field
+    int shaft = getWidth() / 2 - 2;
+
+    // leave a center channel empty by clearing the hash table in this location
+    for (int i = shaft; i < shaft + SPRITE_WIDTH; i++)
+        for (int j = 4; j < getMaxY(); j++)
+            setEarthInvis(i, j);
 
     // distribute L barrels randomly across the field
     for (int i = 0; i < L; i++) {
-        // randomly generate coordinates
-        int x = RNG(0, 60);
-        int y = RNG(0, 56);
-
-        // if the coordinates are too close to another object or if they are in the main shaft, repeatedly generate again
-        while (distributionCollision(x, y) || (26 <= x && x <= 34 && y > 3)) {
-            x = RNG(0, 60);
-            y = RNG(0, 56);
+        // randomly generate coordinates away from other objects and the main shaft
+        // if there is no room left, the level needs one less barrel
+        int x, y;
+        if (!findOpenSpot(x, y, 0, getMaxX(), 0, getMaxY() - 4, shaft)) {
+            player->decBarrels();
+            continue;
         }
 
-        // create a new Barrel object with the generated coordinates and add it to the list of objects
+        // create a new Barrel object with the generated coordinates and add it to the goods
         Barrel* temp = new Barrel(x, y, this);
-        actors.push_back(temp);
+        addGoods(temp);
     }
 
     // number of gold objects to spawn at beginning
@@ -72,19 +94,14 @@ int StudentWorld::init()
 
     // distribute G gold nuggets randomly across the field
     for (int i = 0; i < G; i++) {
-        // randomly generate coordinates
-        int x = RNG(0, 60);
-        int y = RNG(0, 56);
-
-        // if the coordinates are too close to another object or if they are in the main shaft, repeatedly generate again
-        while (distributionCollision(x, y) || (26 <= x && x <= 34 && y > 3)) {
-            x = RNG(0, 60);
-            y = RNG(0, 56);
-        }
+        // randomly generate coordinates away from other objects and the main shaft, skipping the nugget if there is no room
+        int x, y;
+        if (!findOpenSpot(x, y, 0, getMaxX(), 0, getMaxY() - 4, shaft))
+            continue;
 
-        // create a new GoldNugget object with the generated coordinates and add it to the list of objects
-        GoldNugget* temp = new GoldNugget(x, y, 1, false, this);
-        actors.push_back(temp);
+        // create a new GoldNugget object with the generated coordinates and add it to the goods
+        GoldNugget* temp = nuggetPool.create(x, y, 1, false, this);
+        addGoods(temp);
     }
 
     // number of Boulder objects to spawn at beginning
@@ -92,19 +109,14 @@ int StudentWorld::init()
 
     // distribute B Boulders randomly across the field
     for (int i = 0; i < B; i++) {
-        // randomly generate coordinates
-        int x = RNG(1, 59);
-        int y = RNG(20, 55);
-
-        // if the coordinates are too close to another object or if they are in the main shaft, repeatedly generate again
-        while (distributionCollision(x, y) || (26 <= x && x <= 34 && y > 3)) {
-            x = RNG(1, 59);
-            y = RNG(20, 55);
-        }
+        // randomly generate coordinates away from other objects and the main shaft, skipping the boulder if there is no room
+        int x, y;
+        if (!findOpenSpot(x, y, 1, getMaxX() - 1, 20, getMaxY() - 5, shaft))
+            continue;
 
-        // create a new Boulder object with the generated coordinates and add it to the list of objects
+        // create a new Boulder object with the generated coordinates and add it to the boulders
         Boulder* temp = new Boulder(x, y, this);
-        actors.push_back(temp);
+        addBoulder(temp);
 
         // clear the hash table at the coordinates that this Boulder occupies
         // then mark it as containing a Boulder
@@ -122,63 +134,93 @@ int StudentWorld::init()
 // controls actions of actors
 int StudentWorld::move()
 {
-    updateText(); // updates the text at the beginning of the game
+    // each block below is one phase of the tick, timed when profiling is turned on (see Profiler.h)
+    PROFILE_TICK(profiler);
 
-    // iterate through all objs in list
-    std::list<obj*>::iterator it = actors.begin();
-    while (it != actors.end()) {
-        (**it).doSomething(); // tell the obj to do something
-
-        // if the player is dead, immediately end the game
-        if (!player->getStatus()) // immediately end game if hp <= 0
-        {
-            decLives(); // decrement player lives
-
-            playSound(SOUND_PLAYER_GIVE_UP); // play the death sound
+    {
+        PROFILE_SCOPE(profiler, TEXT);
+        updateText(); // updates the text at the beginning of the game
+    }
 
-            return GWSTATUS_PLAYER_DIED; // end game
-        }
+    // the player acts first, then each kind of obj in a fixed order
+    int status;
+    {
+        PROFILE_SCOPE(profiler, PLAYER);
+        player->doSomething();
+        status = checkLevelEnd();
+    }
+    if (status != GWSTATUS_CONTINUE_GAME)
+        return status;
 
-        // if the player has collected all barrels, move onto the next stage
-        if (player->getBarrels() <= 0) {
-            playSound(SOUND_FINISHED_LEVEL); // play finish level sound
+    {
+        PROFILE_SCOPE(profiler, BOULDERS);
+        status = moveGroup(boulderWheel);
+    }
+    if (status != GWSTATUS_CONTINUE_GAME)
+        return status;
 
-            return GWSTATUS_FINISHED_LEVEL; // continue to next level
-        }
+    {
+        PROFILE_SCOPE(profiler, PROTESTERS);
+        status = moveGroup(protesterWheel);
+    }
+    if (status != GWSTATUS_CONTINUE_GAME)
+        return status;
 
-        // if obj is dead, delete it from the list
-        if (!((*it)->getStatus())) {
-            // if a protester is about to be deleted, decrement the count of protesters
-            if ((*it)->getID() == TID_PROTESTER || (*it)->getID() == TID_HARD_CORE_PROTESTER)
-                protesterCount--;
+    {
+        PROFILE_SCOPE(profiler, GOODS);
+        status = moveGroup(goods);
+    }
+    if (status != GWSTATUS_CONTINUE_GAME)
+        return status;
 
-            delete *it;
-            it = actors.erase(it);
-            continue;
+    {
+        PROFILE_SCOPE(profiler, SQUIRTS);
+        status = moveGroup(squirts);
+    }
+    if (status != GWSTATUS_CONTINUE_GAME)
+        return status;
+
+    {
+        PROFILE_SCOPE(profiler, SWEEP);
+
+        // every obj has acted, so sweep out the dead ones in one pass per kind
+        sweepGroup<Boulder>(boulders, NULL, &boulderWheel);
+        sweepGroup(protesters, &protesterGrid, &protesterWheel);
+        sweepGroup<Goods>(goods, &goodsGrid, NULL);
+        sweepGroup<Squirt>(squirts, NULL, NULL);
+
+        // then let the objs spawned during the tick join the game
+        // the frontend already knows about them from when they were spawned
+        for (size_t i = 0; i < stagedSquirts.size(); i++)
+            squirts.push_back(stagedSquirts[i]);
+        for (size_t i = 0; i < stagedGoods.size(); i++) {
+            goods.push_back(stagedGoods[i]);
+            goodsGrid.insert(stagedGoods[i], stagedGoods[i]->getX(), stagedGoods[i]->getY());
         }
 
-        it++; // move onto the next item in the list
+        stagedSquirts.clear();
+        stagedGoods.clear();
     }
 
+    PROFILE_SCOPE(profiler, SPAWN); // the rest of the tick only spawns new objs
+
     // if there are't the max number of protesters on the field and if enough ticks have passed to add a new protester
-    if (protesterCount < int(15 < 2 + getLevel() * 1.5 ? 15 : 2 + getLevel() * 1.5) && protesterCountdown <= 0) {
+    if (int(protesters.size()) < int(15 < 2 + getLevel() * 1.5 ? 15 : 2 + getLevel() * 1.5) && protesterCountdown <= 0) {
         // there is a probOfHard% chance that a hard protester will spawn. else, a regular protester will spawn
         int probOfHardProt = (90 < getLevel() * 10 + 30 ? 90 : getLevel() * 10 + 30);
 
         // simulates a probOfHardProt% draw to determine what type of protester is drawn
         // if the number generated is <= probOfHardProt, a hard protester will be added
         if (RNG(1, 100) <= probOfHardProt) {
-            obj* temp = new HardProtester(this);
-            actors.push_back(temp);
+            HardProtester* temp = new HardProtester(this);
+            addProtester(temp);
         }
         // else, a regular protester will be added
         else {
-            obj* temp = new RegularProtester(this);
-            actors.push_back(temp);
+            RegularProtester* temp = new RegularProtester(this);
+            addProtester(temp);
         }
 
-        protesterCount++; // since a protester was just added, increment the count of protesters by 1
-
         protesterCountdown = (25 > 200 - getLevel() ? 25 : 200 - getLevel()); /// reset protester countdown
     }
     else
@@ -189,28 +231,33 @@ int StudentWorld::move()
         // simulates a 1/5 chance of the good being a sonarcharge
         if (RNG(1, 5) == 1) {
             // if there is not a sonar on the map and the sonar does not collide with anything
-            if (!distributionCollision(0, 60)) {
-                // create a new sonar object and add it to the list of obj
-                Sonar* temp = new Sonar(0, 60, this);
-                actors.push_back(temp);
+            if (!distributionCollision(0, getMaxY())) {
+                // create a new sonar object and add it to the goods
+                Sonar* temp = sonarPool.create(0, getMaxY(), this);
+                addGoods(temp);
             }
         }
 
         // else the good must be a waterpool
         else {
             // randomly generate coordinates
-            int x = RNG(0, 60);
-            int y = RNG(0, 60);
+            int x = RNG(0, getMaxX());
+            int y = RNG(0, getMaxY());
 
             // if the coordinates overlap with dirt or if they are too close to another object, repeatedledly regenerate
-            while (distributionCollision(x, y) || dirtHere(x, y)) {
-                x = RNG(0, 60);
-                y = RNG(0, 60);
+            // a crowded field may have no open spot, so give up after MAX_PLACEMENT_TRIES draws and try again on a later tick
+            int tries = 1;
+            while ((distributionCollision(x, y) || dirtHere(x, y)) && tries < MAX_PLACEMENT_TRIES) {
+                x = RNG(0, getMaxX());
+                y = RNG(0, getMaxY());
+                tries++;
             }
 
-            // create a new waterpool at (x, y) and add it to the list of objects
-            WaterPool* temp = new WaterPool(x, y, this);
-            actors.push_back(temp);
+            // create a new waterpool at (x, y) and add it to the goods
+            if (!distributionCollision(x, y) && !dirtHere(x, y)) {
+                WaterPool* temp = waterPool.create(x, y, this);
+                addGoods(temp);
+            }
         }
     }
 
@@ -220,20 +267,25 @@ int StudentWorld::move()
 // destructs objects when game ends
 void StudentWorld::cleanUp()
 {
-    // deletes all objects in the cnotainer of actors
-    // unnecessary to individually delete player since it is in actors
-    std::list<obj*>::iterator it = actors.begin();
-    while (it != actors.end()) {
-        delete *it;
-        it = actors.erase(it);
-    }
+    // deletes the player and every obj of each kind
+    retire(player);
 
-    // deletes everything in the hash table
-    for (int i = 0; i < 64; i++) {
-        for (int j = 0; j < 60; j++) {
-            delete pixelArr[i][j];
-        }
-    }
+    destroyGroup(boulders);
+    destroyGroup(protesters);
+    destroyGroup(goods);
+    destroyGroup(squirts);
+
+    // the level may have ended before the staged objs joined the game
+    destroyGroup(stagedSquirts);
+    destroyGroup(stagedGoods);
+
+    // empty the spatial grids and timer wheels along with the objs
+    protesterGrid.clear();
+    goodsGrid.clear();
+    boulderWheel.clear();
+    protesterWheel.clear();
+
+    PROFILE_END_LEVEL(profiler, getLevel()); // write out the profile of the level that just ended
 }
 
 // returns a pointer to player
@@ -242,52 +294,310 @@ TunnelMan* StudentWorld::getPlayer()
     return player;
 }
 
+#ifdef TUNNELMAN_PROFILE
+// returns the profiler
+Profiler& StudentWorld::getProfiler()
+{
+    return profiler;
+}
+#endif
+
 // returns the ID that is stored at (x, y) in the hash table
 // returns -1 if out of bounds
 int StudentWorld::getPixelArrID(int x, int y)
 {
     // if empty Earth at top of game, return -1 for no Earth/Boulder
-    if (x < 64 && x >= 0 && y >= 60 && y < 64)
+    if (x < getWidth() && x >= 0 && y >= getMaxY() && y < getHeight())
         return -1;
 
     // if out of bounds of array, return OUT_OF_BOUNDS
-    if (x >= 64 || y >= 60 || x < 0 || y < 0)
+    if (x >= getWidth() || y >= getMaxY() || x < 0 || y < 0)
         return OUT_OF_BOUNDS;
 
-    return pixelArr[x][y]->ID; // else return the ID at this location
+    return terrain.cellID(x, y); // else return the ID at this location
 }
 
 // update the ID of the hashtable at (x, y)
 void StudentWorld::changePixelArrID(int x, int y, int ID)
 {
-    pixelArr[x][y]->changeID(ID); // change the ID
+    terrain.setCellID(x, y, ID); // change the ID
+
+    // if the cell was cleared, the distance fields can be repaired in place
+    // else space was filled in, so the distance fields must be rebuilt
+    if (ID == -1)
+        terrainOpened(x, y, 1, 1);
+    else
+        terrainClosed(x, y, 1, 1);
 }
 
 // set the Earth to invisible at the location(x, y) on the hash table
 void StudentWorld::setEarthInvis(int x, int y)
 {
-    pixelArr[x][y]->dirt->setVisible(false); // make the Earth invisible
+    frontend->earthRemoved(x, y); // make the Earth invisible
+
+    terrain.setCellID(x, y, -1); // clear the value on the hash table
+
+    terrainOpened(x, y, 1, 1); // repair the distance fields around the cleared cell
+}
+
+// removes the Earth in the w by h rectangle at (x, y), clearing each row of the bitboard with one mask
+// returns true if any Earth was dug so the caller can play the dig sound
+bool StudentWorld::digEarth(int x, int y, int w, int h)
+{
+    bool dug = false;
+
+    // the terrain clears at most 64 columns at a time, which is always one call in the game's own field
+    for (int j = y; j < y + h; j++) {
+        for (int start = x; start < x + w; start += 64) {
+            int len = (x + w - start < 64) ? x + w - start : 64;
+            uint64_t cleared = terrain.clearEarth(start, j, len); // columns that held Earth in this run, from start
+
+            // hide the Earth that was removed
+            for (int i = 0; cleared != 0; i++) {
+                if ((cleared >> i) & 1) {
+                    frontend->earthRemoved(start + i, j);
+                    cleared &= ~(uint64_t(1) << i);
+                    dug = true;
+                }
+            }
+        }
+    }
+
+    // repair the distance fields around the whole rectangle at once
+    if (dug)
+        terrainOpened(x, y, w, h);
+
+    return dug;
+}
+
+// returns the terrain version, which the distance fields are checked against before use
+unsigned long StudentWorld::getTerrainVersion()
+{
+    return terrainVersion;
+}
+
+// files the boulder under the pass it wakes on
+void StudentWorld::sleepFor(Boulder* boulder, long passes)
+{
+    boulderWheel.sleepFor(boulder, passes);
+}
+
+// files the protester under the pass it wakes on
+void StudentWorld::sleepFor(ProtesterTemplate* protester, long passes)
+{
+    protesterWheel.sleepFor(protester, passes);
+}
+
+// moves the boulder back to the boulders due to act
+long StudentWorld::wake(Boulder* boulder)
+{
+    return boulderWheel.wake(boulder);
+}
+
+// moves the protester back to the protesters due to act
+long StudentWorld::wake(ProtesterTemplate* protester)
+{
+    return protesterWheel.wake(protester);
+}
+
+// adds a watch for the rectangle, a listener can watch more than one
+void StudentWorld::watchTerrain(TerrainListener* listener, int x, int y, int w, int h)
+{
+    terrainWatch watch;
+    watch.listener = listener;
+    watch.x = x;
+    watch.y = y;
+    watch.w = w;
+    watch.h = h;
+    terrainWatches.push_back(watch);
+}
+
+// removes every watch listener has, swapping the last watch into each hole since their order does not matter
+void StudentWorld::unwatchTerrain(TerrainListener* listener)
+{
+    for (size_t i = 0; i < terrainWatches.size();) {
+        if (terrainWatches[i].listener == listener) {
+            terrainWatches[i] = terrainWatches.back();
+            terrainWatches.pop_back();
+        }
+        else
+            i++;
+    }
+}
+
+// returns the bitboard layer holding the Earth and Boulders
+const Terrain& StudentWorld::getTerrain()
+{
+    return terrain;
+}
+
+// returns true and sets value if a key was pressed
+bool StudentWorld::getKey(int& value)
+{
+    return frontend->getKey(value);
+}
+
+// plays the sound soundID through the frontend
+void StudentWorld::playSound(int soundID)
+{
+    frontend->playSound(soundID);
+}
+
+// sets the text at the top of the screen
+void StudentWorld::setGameStatText(std::string text)
+{
+    frontend->setGameStatText(text);
+}
+
+// returns the current level
+unsigned int StudentWorld::getLevel() const
+{
+    return frontend->getLevel();
+}
+
+// returns the number of lives left
+unsigned int StudentWorld::getLives() const
+{
+    return frontend->getLives();
+}
+
+// takes away one of the player's lives
+void StudentWorld::decLives()
+{
+    frontend->decLives();
+}
+
+// returns the game's score
+unsigned int StudentWorld::getScore() const
+{
+    return frontend->getScore();
+}
+
+// increases the game's score
+void StudentWorld::increaseScore(unsigned int howMuch)
+{
+    frontend->increaseScore(howMuch);
+}
+
+// adds protester to the protesters, to the bucket of their spatial grid covering its location and to their timer wheel
+void StudentWorld::addProtester(ProtesterTemplate* protester)
+{
+    frontend->objAdded(protester);
+    protesters.push_back(protester);
+    protesterGrid.insert(protester, protester->getX(), protester->getY());
+    protesterWheel.add(protester);
+}
+
+// adds good to the goods and to the bucket of their spatial grid covering its location
+void StudentWorld::addGoods(Goods* good)
+{
+    frontend->objAdded(good);
+    goods.push_back(good);
+    goodsGrid.insert(good, good->getX(), good->getY());
+}
+
+// adds squirt to the squirts
+void StudentWorld::addSquirt(Squirt* squirt)
+{
+    frontend->objAdded(squirt);
+    squirts.push_back(squirt);
+}
+
+// adds boulder to the boulders and to their timer wheel
+void StudentWorld::addBoulder(Boulder* boulder)
+{
+    frontend->objAdded(boulder);
+    boulders.push_back(boulder);
+    boulderWheel.add(boulder);
+}
+
+// makes the Squirt in a recycled slot and holds it until the end of the tick
+// the frontend is told about it right away, since it is destroyed through retire even if it never joins the game
+void StudentWorld::spawnSquirt(int x, int y, obj::Direction dir)
+{
+    Squirt* temp = squirtPool.create(x, y, dir, this);
+    frontend->objAdded(temp);
+    stagedSquirts.push_back(temp);
+}
+
+// makes the GoldNugget in a recycled slot and holds it until the end of the tick, like spawnSquirt
+void StudentWorld::spawnNugget(int x, int y, int ticks, bool prot)
+{
+    GoldNugget* temp = nuggetPool.create(x, y, ticks, prot, this);
+    frontend->objAdded(temp);
+    stagedGoods.push_back(temp);
+}
+
+// the frontend stops drawing item before its storage is freed or recycled
+void StudentWorld::retire(obj* item)
+{
+    frontend->objRemoved(item);
+    item->destroy();
+}
+
+// gives the Squirt's slot back to its pool
+void StudentWorld::recycle(Squirt* squirt)
+{
+    squirtPool.destroy(squirt);
+}
+
+// gives the GoldNugget's slot back to its pool
+void StudentWorld::recycle(GoldNugget* nugget)
+{
+    nuggetPool.destroy(nugget);
+}
+
+// gives the Sonar's slot back to its pool
+void StudentWorld::recycle(Sonar* sonar)
+{
+    sonarPool.destroy(sonar);
+}
+
+// gives the WaterPool's slot back to its pool
+void StudentWorld::recycle(WaterPool* pool)
+{
+    waterPool.destroy(pool);
+}
+
+// called by ProtesterTemplate::moved so the spatial grid always files protester under its current location
+void StudentWorld::protesterMoved(ProtesterTemplate* protester, int oldX, int oldY)
+{
+    protesterGrid.move(protester, oldX, oldY, protester->getX(), protester->getY());
+}
 
-    pixelArr[x][y]->changeID(-1); // clear the value on the hash table
+// called by Goods::moved so the spatial grid always files good under its current location
+void StudentWorld::goodsMoved(Goods* good, int oldX, int oldY)
+{
+    goodsGrid.move(good, oldX, oldY, good->getX(), good->getY());
 }
 
-// return the list of obj
-std::list<obj*>& StudentWorld::getActors()
+// checked after every obj acts, since any of them can end the level
+int StudentWorld::checkLevelEnd()
 {
-    return actors;
+    // if the player is dead, immediately end the game
+    if (!player->getStatus()) // immediately end game if hp <= 0
+    {
+        decLives(); // decrement player lives
+
+        playSound(SOUND_PLAYER_GIVE_UP); // play the death sound
+
+        return GWSTATUS_PLAYER_DIED; // end game
+    }
+
+    // if the player has collected all barrels, move onto the next stage
+    if (player->getBarrels() <= 0) {
+        playSound(SOUND_FINISHED_LEVEL); // play finish level sound
+
+        return GWSTATUS_FINISHED_LEVEL; // continue to next level
+    }
+
+    return GWSTATUS_CONTINUE_GAME;
 }
 
 // checks if there is dirt overlapping with the sprite
 bool StudentWorld::dirtHere(int x, int y)
 {
-    // for each pixel in the sprite
-    for (int i = x; i < x + SPRITE_WIDTH; i++)
-        for (int j = y; j < y + SPRITE_HEIGHT; j++)
-            // if the hash table corresponding to the pixel has Earth
-            if (getPixelArrID(i, j) == TID_EARTH || getPixelArrID(i, j) == TID_BOULDER)
-                return true; // return true
-
-    return false; // else there is no overlap, so return false
+    return terrain.dirtHere(x, y);
 }
 
 // calculate the Euclidean distance between (x1, y1) and (x2, y2)
@@ -296,39 +606,330 @@ double StudentWorld::calcDist(int x1, int y1, int x2, int y2)
     return sqrt(pow(1.0 * x1 - x2, 2) + pow(1.0 * y1 - y2, 2)); // the formula
 }
 
-// generates a random number from min to max, inclusive
+// generates a random number from min to max, inclusive, using this world's generator
 int StudentWorld::RNG(int min, int max)
 {
-    return (rand() % (max - min + 1)) + min;
+    return rng.bounded(min, max);
+}
+
+// returns the next coordinate on a shortest path from (x, y) to the exit
+// the exit field is shared by all protesters and is kept up to date as the terrain is dug
+std::pair<int, int> StudentWorld::getExitStep(int x, int y)
+{
+    // if the field is behind the terrain version, rebuild it from the exit
+    if (exitField.version != terrainVersion) {
+        makeDistField(exitField, getMaxX(), getMaxY(), INT_MAX);
+        exitField.version = terrainVersion;
+    }
+
+    return stepDownhill(exitField, x, y);
+}
+
+// returns the chase range for this level
+int StudentWorld::getChaseRange()
+{
+    return chaseRange;
+}
+
+// returns the number of moves from (x, y) to the player, -1 if it is not within the chase range
+// every move changes x or y by one, so a protester is never fewer moves away than its Manhattan distance.
+// a protester that is too far away by that measure gives up without the field being built at all
+int StudentWorld::getPlayerDist(int x, int y)
+{
+    if (abs(x - player->getX()) + abs(y - player->getY()) >= chaseRange)
+        return -1;
+
+    updatePlayerField();
+
+    return playerField.at(x, y);
+}
+
+// returns the next coordinate on a shortest path from (x, y) to the player
+std::pair<int, int> StudentWorld::getPlayerStep(int x, int y)
+{
+    updatePlayerField();
+
+    return stepDownhill(playerField, x, y);
+}
+
+// brings the player field up to date with the player's location
+// the field is keyed on the player's cell and the terrain version, and digging repairs it in place, so it only
+// changes on the ticks the player steps to a new cell. it is shared by every hardcore protester
+// a single step on unchanged terrain re-roots the field, which only visits the positions the step brought closer.
+// anything else, such as filled-in terrain or a jump of several cells, rebuilds it
+// only distances below the chase range matter, so the search stops there instead of covering the whole field
+void StudentWorld::updatePlayerField()
+{
+    int x = player->getX();
+    int y = player->getY();
+
+    if (playerField.version == terrainVersion && playerField.sourceX == x && playerField.sourceY == y)
+        return;
+
+    if (playerField.version == terrainVersion && abs(x - playerField.sourceX) + abs(y - playerField.sourceY) == 1 &&
+        playerField.offset < MAX_FIELD_OFFSET && !dirtHere(x, y))
+        rerootDistField(playerField, x, y);
+    else
+        rebuildPlayerField();
+}
+
+// the countdown is only reset once a protester is added, which this keeps from happening this level
+void StudentWorld::holdProtesterSpawns()
+{
+    protesterCountdown = INT_MAX;
+}
+
+// does the same search as getExitStep on a field that is behind, so its cost can be timed on its own
+void StudentWorld::rebuildExitField()
+{
+    makeDistField(exitField, getMaxX(), getMaxY(), INT_MAX);
+    exitField.version = terrainVersion;
+}
+
+// does the same search as updatePlayerField when it cannot re-root the field, which the bench also times on its own
+void StudentWorld::rebuildPlayerField()
+{
+    makeDistField(playerField, player->getX(), player->getY(), chaseRange - 1);
+    playerField.version = terrainVersion;
+}
+
+// repairs every distance field that was up to date after the rectangle at (x, y) was cleared
+// fields that are already behind are skipped since they will be rebuilt with the new terrain anyway
+void StudentWorld::terrainOpened(int x, int y, int w, int h)
+{
+    publishTerrainChange(x, y, w, h);
+
+    unsigned long previous = terrainVersion++;
+
+    if (exitField.version == previous) {
+        repairDistField(exitField, x, y, w, h);
+        exitField.version = terrainVersion;
+    }
+
+    if (playerField.version == previous) {
+        repairDistField(playerField, x, y, w, h);
+        playerField.version = terrainVersion;
+    }
+}
+
+// filling space can make distances longer, which a repair cannot handle, so every field falls behind
+// and is rebuilt the next time it is used
+void StudentWorld::terrainClosed(int x, int y, int w, int h)
+{
+    publishTerrainChange(x, y, w, h);
+
+    terrainVersion++;
+}
+
+// listeners only note the change, so none of them can add or remove a watch while this loops
+void StudentWorld::publishTerrainChange(int x, int y, int w, int h)
+{
+    for (size_t i = 0; i < terrainWatches.size(); i++) {
+        const terrainWatch& watch = terrainWatches[i];
+
+        // skip watches that do not overlap the rectangle
+        if (x >= watch.x + watch.w || watch.x >= x + w || y >= watch.y + watch.h || watch.y >= y + h)
+            continue;
+
+        watch.listener->terrainChanged(x, y, w, h);
+    }
+}
+
+// fills field with the number of steps from every position to (x, y), up to limit steps
+// positions that cannot be reached within limit steps are marked with -1
+void StudentWorld::makeDistField(distField& field, int x, int y, int limit)
+{
+    PROFILE_SCOPE(profiler, PATHS);
+    PROFILE_COUNT(profiler, PATH_SEARCHES, 1);
+
+    // mark every position as undiscovered, which is just a new stamp
+    field.clear();
+    field.offset = 0;
+
+    field.limit = limit;
+    field.sourceX = x;
+    field.sourceY = y;
+
+    // the source is zero steps away from itself
+    field.set(x, y, 0);
+    frontier.clear();
+    frontier.push_back(std::pair<int, int>(x, y));
+
+    spreadDistField(field);
+}
+
+// lowers the distances in field after the w by h rectangle at (x, y) was cleared
+// clearing cells can only open up space, so distances can only shrink. only the positions whose sprite
+// covers the rectangle can become open, and only the positions that end up closer to the source are visited,
+// so a dig costs about as much as the area it actually changes
+// every newly open position is attached before any distances are spread, so each one sees all of its
+// neighbours that were already reachable
+void StudentWorld::repairDistField(distField& field, int x, int y, int w, int h)
+{
+    PROFILE_SCOPE(profiler, PATHS);
+    PROFILE_COUNT(profiler, PATH_SEARCHES, 1);
+
+    frontier.clear(); // positions whose distance was just lowered
+
+    // for every position whose sprite would cover part of the rectangle
+    for (int i = (x - 3 > 0 ? x - 3 : 0); i < x + w && i <= getMaxX(); i++) {
+        for (int j = (y - 3 > 0 ? y - 3 : 0); j < y + h && j <= getMaxY(); j++) {
+            // skip positions that were already reachable or that are still blocked
+            if (field.at(i, j) != -1 || dirtHere(i, j))
+                continue;
+
+            // the position just opened up, so it is one step further than its closest reachable neighbour
+            int best = -1;
+            if (i - 1 >= 0 && field.at(i - 1, j) != -1)
+                best = field.at(i - 1, j) + 1;
+            if (i + 1 <= getMaxX() && field.at(i + 1, j) != -1 && (best == -1 || field.at(i + 1, j) + 1 < best))
+                best = field.at(i + 1, j) + 1;
+            if (j - 1 >= 0 && field.at(i, j - 1) != -1 && (best == -1 || field.at(i, j - 1) + 1 < best))
+                best = field.at(i, j - 1) + 1;
+            if (j + 1 <= getMaxY() && field.at(i, j + 1) != -1 && (best == -1 || field.at(i, j + 1) + 1 < best))
+                best = field.at(i, j + 1) + 1;
+
+            // if it connects to the field within the limit, push it so its neighbours can be lowered too
+            if (best != -1 && best <= field.limit) {
+                field.set(i, j, best);
+                frontier.push_back(std::pair<int, int>(i, j));
+            }
+        }
+    }
+
+    spreadDistField(field);
+}
+
+// moves the source of field one step to (x, y)
+// both sources are open and next to each other, so no position is more than one step further from (x, y) than it was
+// from the old source. bumping the offset makes every distance one step longer at once, which is then exact for every
+// position the step took further away, and a BFS from (x, y) lowers the rest. that BFS only visits the positions that
+// are at least as close to (x, y) as they were to the old source, which is about half of the positions a build visits
+// positions pushed past the limit by the offset read as -1, just like positions a build never reached
+void StudentWorld::rerootDistField(distField& field, int x, int y)
+{
+    PROFILE_SCOPE(profiler, PATHS);
+    PROFILE_COUNT(profiler, PATH_SEARCHES, 1);
+
+    field.offset++;
+    field.sourceX = x;
+    field.sourceY = y;
+
+    // the new source is zero steps away from itself
+    field.set(x, y, 0);
+    frontier.clear();
+    frontier.push_back(std::pair<int, int>(x, y));
+
+    spreadDistField(field);
+}
+
+// BFS outwards from the positions in frontier, giving every open neighbour a distance one larger
+// than the position it was reached from if that is shorter than what it already has
+// frontier is read from the front while new positions are appended, so it works as a queue without popping anything
+void StudentWorld::spreadDistField(distField& field)
+{
+    // offsets to the right, upper, left, and lower neighbours of a position
+    const int dx[4] = { 1, 0, -1, 0 };
+    const int dy[4] = { 0, 1, 0, -1 };
+
+    // while there are positions left in the queue
+    for (size_t next = 0; next < frontier.size(); next++) {
+        // get the next item of the queue, copied out since appending may move the storage
+        int currX = frontier[next].first;
+        int currY = frontier[next].second;
+        PROFILE_COUNT(profiler, NODES_EXPANDED, 1);
+
+        int nextDist = field.at(currX, currY) + 1;
+
+        // positions past the limit are left unmarked
+        if (nextDist > field.limit)
+            continue;
+
+        // for each of the four neighbours
+        for (int k = 0; k < 4; k++) {
+            int nextX = currX + dx[k];
+            int nextY = currY + dy[k];
+
+            // if the neighbour is out of bounds or already at least as close, skip it
+            if (nextX < 0 || nextX > getMaxX() || nextY < 0 || nextY > getMaxY())
+                continue;
+            if (field.at(nextX, nextY) != -1 && field.at(nextX, nextY) <= nextDist)
+                continue;
+
+            // if the neighbour is open, mark it with its new distance and push it into the queue
+            if (!dirtHere(nextX, nextY)) {
+                field.set(nextX, nextY, nextDist);
+                frontier.push_back(std::pair<int, int>(nextX, nextY));
+            }
+        }
+    }
+}
+
+// returns the neighbour of (x, y) that is one step closer to the source of field
+// returns (x, y) itself if it is the source or cannot reach the source
+std::pair<int, int> StudentWorld::stepDownhill(distField& field, int x, int y)
+{
+    int dist = field.at(x, y);
+
+    // if already at the source or unreachable, stay in place
+    if (dist <= 0)
+        return std::pair<int, int>(x, y);
+
+    // check the left, right, lower, and upper neighbours for one that is one step closer
+    if (x - 1 >= 0 && field.at(x - 1, y) == dist - 1)
+        return std::pair<int, int>(x - 1, y);
+    if (x + 1 <= getMaxX() && field.at(x + 1, y) == dist - 1)
+        return std::pair<int, int>(x + 1, y);
+    if (y - 1 >= 0 && field.at(x, y - 1) == dist - 1)
+        return std::pair<int, int>(x, y - 1);
+    if (y + 1 <= getMaxY() && field.at(x, y + 1) == dist - 1)
+        return std::pair<int, int>(x, y + 1);
+
+    return std::pair<int, int>(x, y);
 }
 
 // check if (x, y) is within six units of something else
 bool StudentWorld::distributionCollision(int x, int y)
 {
-    // iterate through the objs in the list
-    std::list<obj*>::iterator it = actors.begin();
-    while (it != actors.end()) {
-        int ID = (*it)->getID(); // get the ID of the obj
+    // the player and the boulders are checked directly, since there are only a few of them
+    if (calcDist(x, y, player->getX(), player->getY()) <= 6)
+        return true;
 
-        // if the ID is one of the ones lists
-        if (ID == TID_BOULDER || ID == TID_GOLD || ID == TID_BARREL || ID == TID_SONAR || ID == TID_WATER_POOL
-            || ID == TID_PLAYER || ID == TID_PROTESTER || ID == TID_HARD_CORE_PROTESTER) {
-            // get the obj's coordinates
-            int x1 = (*it)->getX();
-            int y1 = (*it)->getY();
+    for (size_t i = 0; i < boulders.size(); i++)
+        if (calcDist(x, y, boulders[i]->getX(), boulders[i]->getY()) <= 6)
+            return true;
 
-            // calculate the distance from (x, y) to the obj's coords
-            double dist = calcDist(x, y, x1, y1);
+    // every protester and good within six units counts, so stop at the first one found
+    if (forEachProtesterNear(x, y, 6, [](ProtesterTemplate*) { return true; }))
+        return true;
 
-            // if the distance <= 6, return true
-            if (dist <= 6.0)
-                return true;
-        }
+    return forEachGoodsNear(x, y, 6, [](Goods*) { return true; });
+}
+
+// draws spots until one is clear of other objects and of the center shaft, giving up after MAX_PLACEMENT_TRIES draws
+// x is drawn before y on every try, so a field with room draws the same numbers as always
+bool StudentWorld::findOpenSpot(int& x, int& y, int minX, int maxX, int minY, int maxY, int shaft)
+{
+    for (int tries = 0; tries < MAX_PLACEMENT_TRIES; tries++) {
+        x = RNG(minX, maxX);
+        y = RNG(minY, maxY);
 
-        it++; // continue onto the next obj in the list
+        // the spot is open if it is far enough from everything and not in the main shaft below the top band
+        if (!distributionCollision(x, y) && !(shaft - 4 <= x && x <= shaft + 4 && y > 3))
+            return true;
     }
 
-    return false; // there were no objs six units nearby, so return false
+    return false;
+}
+
+// checks the requested size before the terrain and grids are sized from it
+// the grids would be sized wrong, and init could find no room for the boulders, on any size outside the range
+int StudentWorld::checkSize(int width, int height)
+{
+    if (!worldSizeSupported(width, height))
+        throw std::invalid_argument("unsupported field size");
+
+    return width;
 }
 
 // updates text at the top of the game screen
@@ -1,34 +1,63 @@
 #ifndef STUDENTWORLD_H_
 #define STUDENTWORLD_H_
 
-#include "GameWorld.h"
+#include "GameFrontend.h"
 #include "GameConstants.h"
 #include "Actor.h"
+#include "Terrain.h"
+#include "TerrainListener.h"
+#include "SpatialGrid.h"
+#include "TimerWheel.h"
+#include "ObjectPool.h"
+#include "Random.h"
+#include "Profiler.h"
 #include <string>
-#include <list>
+#include <vector>
+#include <utility>
 
 // Students:  Add code to this file, StudentWorld.cpp, Actor.h, and Actor.cpp
 
-class StudentWorld : public GameWorld {
+// runs the game itself without drawing anything, so it can be driven by GLUT or run headless
+// all input and output goes through the GameFrontend it is given
+class StudentWorld {
 public:
-    // constructor
-    StudentWorld(std::string assetDir);
+    // constructor, frontendIn must outlive the StudentWorld
+    // every random draw in the game comes from seed, so the same seed and keys play out the same game
+    // the field is width by height, including the empty band at the top. the game itself is 64 by 64, other
+    // fields are for stress runs. sizes other than 64 by 64 need a build with TUNNELMAN_DYNAMIC_SIZE, and even then
+    // must be within the range in WorldSize.h. any other size throws std::invalid_argument
+    StudentWorld(GameFrontend* frontendIn, uint64_t seed, int width = 64, int height = 64);
 
-    // virtual destructor
-    virtual ~StudentWorld();
+    // destructor
+    ~StudentWorld();
 
     // runs at start of game
-    virtual int init();
+    int init();
 
     // controls actions of all the actors per tick
-    virtual int move();
+    int move();
 
     // destructs objects when game ends
-    virtual void cleanUp();
+    void cleanUp();
+
+    // the frontend's input, sound, text, and level / lives / score, for use by the actors
+    bool getKey(int& value);
+    void playSound(int soundID);
+    void setGameStatText(std::string text);
+    unsigned int getLevel() const;
+    unsigned int getLives() const;
+    void decLives();
+    unsigned int getScore() const;
+    void increaseScore(unsigned int howMuch);
 
     // returns a pointer to player
     TunnelMan* getPlayer();
 
+#ifdef TUNNELMAN_PROFILE
+    // returns the profiler, to read the ticks of the current level or change where levels are written
+    Profiler& getProfiler();
+#endif
+
     // returns value of hash table at [x][y]
     int getPixelArrID(int x, int y);
 
@@ -38,8 +67,74 @@ public:
     // sets Earth invisible at (x, y)
     void setEarthInvis(int x, int y);
 
-    // returns the list of obj in game
-    std::list<obj*>& getActors();
+    // removes all Earth in the w by h rectangle at (x, y), returns true if any Earth was dug
+    bool digEarth(int x, int y, int w, int h);
+
+    // returns a number that changes every time Earth or Boulders are added or removed
+    unsigned long getTerrainVersion();
+
+    // called during the obj's own turn, puts it to sleep so it is not visited for its next passes turns
+    // passes of LONG_MAX sleeps until wake is called, and passes of 0 or less does nothing
+    void sleepFor(Boulder* boulder, long passes);
+    void sleepFor(ProtesterTemplate* protester, long passes);
+
+    // wakes the obj if it is sleeping, and returns the number of its turns it slept through
+    // it acts on its next turn, and 0 is returned if it was awake or has already been caught up
+    long wake(Boulder* boulder);
+    long wake(ProtesterTemplate* protester);
+
+    // tells listener about every later change to the Earth or Boulders that touches the w by h rectangle at (x, y)
+    void watchTerrain(TerrainListener* listener, int x, int y, int w, int h);
+
+    // stops telling listener about changes, does nothing if it was not watching
+    void unwatchTerrain(TerrainListener* listener);
+
+    // returns the bitboard layer holding the Earth and Boulders
+    const Terrain& getTerrain();
+
+    // adds protester to the protesters in game and files it in their spatial grid
+    void addProtester(ProtesterTemplate* protester);
+
+    // adds good to the goods in game and files it in their spatial grid
+    void addGoods(Goods* good);
+
+    // adds squirt to the squirts in game
+    void addSquirt(Squirt* squirt);
+
+    // adds boulder to the boulders in game
+    void addBoulder(Boulder* boulder);
+
+    // makes a Squirt at (x, y) facing dir from the pool of Squirts
+    // it is staged while objs are acting and joins the game at the end of the tick
+    void spawnSquirt(int x, int y, obj::Direction dir);
+
+    // makes a GoldNugget at (x, y) from the pool of GoldNuggets, staged like spawnSquirt
+    void spawnNugget(int x, int y, int ticks, bool prot);
+
+    // destroy the obj and give its slot back to the pool it came from
+    void recycle(Squirt* squirt);
+    void recycle(GoldNugget* nugget);
+    void recycle(Sonar* sonar);
+    void recycle(WaterPool* pool);
+
+    // moves protester to its new bucket in the spatial grid after it moved from (oldX, oldY)
+    void protesterMoved(ProtesterTemplate* protester, int oldX, int oldY);
+
+    // moves good to its new bucket in the spatial grid after it moved from (oldX, oldY)
+    void goodsMoved(Goods* good, int oldX, int oldY);
+
+    // calls visit(protester) for every protester within radius units of (x, y), in place without copying
+    // visit returns true to stop the search early, and forEachProtesterNear then returns true
+    template <class Visitor>
+    bool forEachProtesterNear(int x, int y, int radius, Visitor visit);
+
+    // calls visit(good) for every good within radius units of (x, y), stopping early like forEachProtesterNear
+    template <class Visitor>
+    bool forEachGoodsNear(int x, int y, int radius, Visitor visit);
+
+    // calls visit(good) for every invisible good within radius units of (x, y), stopping early like forEachProtesterNear
+    template <class Visitor>
+    bool forEachHiddenNear(int x, int y, int radius, Visitor visit);
 
     // returns true if there is dirt in this location
     bool dirtHere(int x, int y);
@@ -47,44 +142,204 @@ public:
     // calculate the distance between (x1, y1) and (x2, y2)
     double calcDist(int x1, int y1, int x2, int y2);
 
-    // generates a random number from min to max, for coordinate generation
+    // generates a random number from min to max, for coordinate generation and every other random choice
     int RNG(int min, int max);
 
+    // returns the size of the field, including the top band
+    // these are defined in this header so a fixed size folds into every bounds check that uses them
+    int getWidth() const;
+    int getHeight() const;
+
+    // returns the largest x and y a sprite can stand at, (60, 60) in the game's own field
+    // the exit is at (getMaxX(), getMaxY())
+    int getMaxX() const;
+    int getMaxY() const;
+
+    // returns the next coordinate on a shortest path from (x, y) to the exit
+    std::pair<int, int> getExitStep(int x, int y);
+
+    // returns the number of moves a hardcore protester can be from the player and still chase it
+    int getChaseRange();
+
+    // returns the number of moves from (x, y) to the player
+    // returns -1 if the player cannot be reached in fewer than getChaseRange() moves
+    int getPlayerDist(int x, int y);
+
+    // returns the next coordinate on a shortest path from (x, y) to the player
+    std::pair<int, int> getPlayerStep(int x, int y);
+
+    // returns true if (x, y) has a distributable good within 6 units
+    bool distributionCollision(int x, int y);
+
+    // hooks for the benchmarks in tools/bench.cpp, which time the game on fixture worlds
+    // keeps the regular spawner from adding protesters for the rest of the level, so the fixture's count stays fixed
+    void holdProtesterSpawns();
+
+    // builds the exit field or the player field from scratch, even if it is already up to date
+    void rebuildExitField();
+    void rebuildPlayerField();
+
 private:
-    // struct for hash table
-    struct pixel {
-        // constructor
-        pixel(int x, int y, StudentWorld* world, int TID)
-        {
-            dirt = new Earth(x, y, world);
-            ID = TID_EARTH;
-        }
+    GameFrontend* frontend; // where input comes from and where sound, text, and drawing notices go
+    Random rng; // this world's own random number generator, shared with no other world
+
+#ifdef TUNNELMAN_PROFILE
+    Profiler profiler; // per-tick phase timings and path search counts, only present in profiling builds
+#endif
+
+    // the obj in game other than Earth, kept apart by kind so each loop only touches the objs it needs
+    // every tick they act in this order: player, boulders, protesters, goods, squirts
+    // within each kind, objs act in the order they were added
+    std::vector<Boulder*> boulders; // every Boulder in game
+    std::vector<ProtesterTemplate*> protesters; // every protester in game, both regular and hardcore
+    std::vector<Goods*> goods; // every Barrel, GoldNugget, Sonar, and WaterPool in game
+    std::vector<Squirt*> squirts; // every Squirt in game
+    SpatialGrid<ProtesterTemplate> protesterGrid; // files every protester by location for radius queries
+    SpatialGrid<Goods> goodsGrid; // files every good by location for radius queries
+
+    // objs spawned by other objs during a tick, added to the game once every obj has acted
+    std::vector<Squirt*> stagedSquirts;
+    std::vector<Goods*> stagedGoods;
+
+    // recycled storage for the objs that come and go during a level
+    ObjectPool<Squirt> squirtPool;
+    ObjectPool<GoldNugget> nuggetPool;
+    ObjectPool<Sonar> sonarPool;
+    ObjectPool<WaterPool> waterPool;
+    Terrain terrain; // hash table for Earth and Boulders, stored as one bitboard row per y, and the size of the field
+    TunnelMan* player; // pointer to the player
+    int goodSpawn; // chance of goods spawning every tick
+    int protesterCountdown; // keeps track of ticks before generating a new protester
+    int chaseRange; // hardcore protesters chase the player when they are fewer than this many moves away
+    unsigned long terrainVersion; // bumped on every change to the Earth or Boulders
+    TimerWheel<Boulder> boulderWheel; // decides which boulders act each tick, sleeping ones are not visited
+    TimerWheel<ProtesterTemplate> protesterWheel; // decides which protesters act each tick, resting ones are not visited
+
+    // struct for one rectangle of the field a TerrainListener is watching
+    struct terrainWatch {
+        TerrainListener* listener; // who to tell
+        int x, y, w, h; // the rectangle being watched
+    };
+
+    std::vector<terrainWatch> terrainWatches; // every rectangle being watched, checked directly since there are only a few
 
-        // destructor
-        ~pixel()
+    // struct for the distance fields protesters use to find the exit and the player
+    // each position is stamped with the build that last reached it, so starting a build only bumps the stamp
+    // instead of clearing every position, and a search costs as much as the positions it actually visits
+    // stored distances are relative to offset, so every distance in the field can be lengthened at once
+    struct distField {
+        // struct for one position of the field
+        struct entry {
+            FieldDist dist; // number of steps to the source less the field's offset, only meaningful if stamp matches the field's
+            uint16_t stamp; // build that last reached this position
+        };
+
+        PositionGrid<entry, WORLD_WIDTH, WORLD_HEIGHT> dist; // the distance and stamp of each position
+        uint16_t stamp; // stamp of the current build
+        unsigned long version; // terrainVersion dist is up to date with, it is rebuilt from scratch before use if this is behind
+        int limit; // largest distance stored, positions further than this from the source are marked -1
+        int sourceX, sourceY; // source of the last build, or of the last re-root
+        int offset; // added to every stored distance, 0 after a build and one more after each re-root
+
+        // returns the number of steps from the position (x, y) to the source
+        // returns -1 if the current build has not reached it, or if a re-root has pushed it past the limit
+        int at(int x, int y)
         {
-            delete dirt;
+            const entry& e = dist.at(x, y);
+            int d = e.dist + offset;
+            return (e.stamp == stamp && d <= limit) ? d : -1;
         }
 
-        // change ID
-        void changeID(int TID)
+        // stores the number of steps from the position (x, y) to the source
+        void set(int x, int y, int d) { entry& e = dist.at(x, y); e.dist = FieldDist(d - offset); e.stamp = stamp; }
+
+        // marks every position as not reached, the stamps are only rewritten when the counter wraps around
+        void clear()
         {
-            ID = TID;
+            if (++stamp == 0) {
+                entry blank = { -1, 0 };
+                dist.fill(blank);
+                stamp = 1;
+            }
         }
-
-        obj* dirt; // contains Earth
-        int ID; // contains TID_EARTH, TID_BOULDER, or -1
     };
 
-    std::list<obj*> actors; // containers all obj except Earth
-    pixel* pixelArr[64][60]; // hash table for Earth and Boulders, and also contains all Earth
-    TunnelMan* player; // pointer to the player
-    int goodSpawn; // chance of goods spawning every tick
-    int protesterCount; // keeps track of number of protesters on field
-    int protesterCountdown; // keeps track of ticks before generating a new protester
+    distField exitField; // distances to the exit
+    distField playerField; // distances to the player up to the chase range, re-rooted or rebuilt when the player changes cell
 
-    // returns true if (x, y) has a distributable good within 6 units
-    bool distributionCollision(int x, int y);
+    // the most re-roots a field takes before it is rebuilt instead, which keeps its stored distances in range of FieldDist
+    static const int MAX_FIELD_OFFSET = 16384;
+
+    // queue shared by every distance field search, emptied at the start of each one
+    // positions are appended at the back and read in order, and the storage is kept between searches so they never allocate
+    std::vector<std::pair<int, int> > frontier;
+
+    // re-roots or rebuilds the player field from the player's location if it is out of date
+    void updatePlayerField();
+
+    // updates the distance fields after the w by h rectangle at (x, y) was cleared of Earth or Boulders
+    void terrainOpened(int x, int y, int w, int h);
+
+    // marks the distance fields out of date after Earth or Boulders were added to the w by h rectangle at (x, y)
+    void terrainClosed(int x, int y, int w, int h);
+
+    // tells every listener watching part of the w by h rectangle at (x, y) that it changed
+    void publishTerrainChange(int x, int y, int w, int h);
+
+    // fills field with the number of steps from every position to (x, y) using BFS
+    // the search stops at limit steps, so only the positions within limit steps of (x, y) are visited
+    void makeDistField(distField& field, int x, int y, int limit);
+
+    // lowers the distances in field after the w by h rectangle at (x, y) was cleared of Earth or Boulders
+    void repairDistField(distField& field, int x, int y, int w, int h);
+
+    // moves the source of field to (x, y), which must be open and one step from the old source on unchanged terrain
+    void rerootDistField(distField& field, int x, int y);
+
+    // continues a BFS over field from the positions in frontier, lowering any distance that can be improved
+    void spreadDistField(distField& field);
+
+    // returns the neighbour of (x, y) that is one step closer to the source of field
+    std::pair<int, int> stepDownhill(distField& field, int x, int y);
+
+    // calls doSomething on every obj in group, for kinds that never sleep
+    // returns GWSTATUS_CONTINUE_GAME, or the status to return from move() if the level ended
+    template <class T>
+    int moveGroup(std::vector<T*>& group);
+
+    // calls doSomething on only the objs of wheel that are due this pass, in the order they were added
+    // returns like the other moveGroup
+    template <class T>
+    int moveGroup(TimerWheel<T>& wheel);
+
+    // destroys every dead obj in group in one pass, removing them from grid and wheel if given and keeping the rest in order
+    template <class T>
+    void sweepGroup(std::vector<T*>& group, SpatialGrid<T>* grid, TimerWheel<T>* wheel);
+
+    // destroys every obj in group and empties it
+    template <class T>
+    void destroyGroup(std::vector<T*>& group);
+
+    // tells the frontend item is leaving the game, then destroys it
+    void retire(obj* item);
+
+    // returns GWSTATUS_CONTINUE_GAME, or the status to return from move() if the player died or found every barrel
+    int checkLevelEnd();
+
+    // calls visit(item) for every item in grid within radius units of (x, y), stopping early if visit returns true
+    template <class T, class Visitor>
+    bool forEachNear(const SpatialGrid<T>& grid, int x, int y, int radius, Visitor visit);
+
+    // draws spots between (minX, minY) and (maxX, maxY) until one is clear of other objects and of the center shaft
+    // whose left column is shaft, stopping after MAX_PLACEMENT_TRIES draws. returns false if no spot was found
+    // a small or crowded field can leave no room at all, so placement must not keep drawing forever
+    bool findOpenSpot(int& x, int& y, int minX, int maxX, int minY, int maxY, int shaft);
+
+    // the most spots drawn for a single object before giving up on it
+    static const int MAX_PLACEMENT_TRIES = 1000;
+
+    // returns width if the world can have a width by height field, otherwise throws std::invalid_argument
+    static int checkSize(int width, int height);
 
     // updates game text at the beginning of every tick
     void updateText();
@@ -93,4 +348,136 @@ private:
     void addLeading(std::string& txt, int numSpaces, std::string add);
 };
 
+// returns the number of columns in the field
+inline int StudentWorld::getWidth() const
+{
+    return terrain.getWidth();
+}
+
+// returns the number of rows in the field, including the top band
+inline int StudentWorld::getHeight() const
+{
+    return terrain.getHeight();
+}
+
+// a sprite is SPRITE_WIDTH wide, so the last column it can start at is SPRITE_WIDTH from the right edge
+inline int StudentWorld::getMaxX() const
+{
+    return terrain.getWidth() - SPRITE_WIDTH;
+}
+
+// a sprite can stand in the top band, so the last row it can start at is the first row of the band
+inline int StudentWorld::getMaxY() const
+{
+    return terrain.getHeight() - SPRITE_HEIGHT;
+}
+
+// only the buckets of the spatial grid around (x, y) are searched, and nothing is allocated
+template <class T, class Visitor>
+bool StudentWorld::forEachNear(const SpatialGrid<T>& grid, int x, int y, int radius, Visitor visit)
+{
+    // dead objs stay in the grid until the end of the tick, so they are skipped here
+    return grid.forEachCandidate(x, y, radius, [&](T* item) {
+        return item->getStatus() && calcDist(x, y, item->getX(), item->getY()) <= radius && visit(item);
+    });
+}
+
+// searches the spatial grid of protesters
+template <class Visitor>
+bool StudentWorld::forEachProtesterNear(int x, int y, int radius, Visitor visit)
+{
+    return forEachNear(protesterGrid, x, y, radius, visit);
+}
+
+// searches the spatial grid of goods
+template <class Visitor>
+bool StudentWorld::forEachGoodsNear(int x, int y, int radius, Visitor visit)
+{
+    return forEachNear(goodsGrid, x, y, radius, visit);
+}
+
+// goods are the only objs that start out hidden, so only their grid is searched
+template <class Visitor>
+bool StudentWorld::forEachHiddenNear(int x, int y, int radius, Visitor visit)
+{
+    return forEachNear(goodsGrid, x, y, radius, [&](Goods* good) {
+        return !good->isVisible() && visit(good);
+    });
+}
+
+// objs spawned while the group acts are staged, so the group never changes size during the loop
+template <class T>
+int StudentWorld::moveGroup(std::vector<T*>& group)
+{
+    for (size_t i = 0; i < group.size(); i++) {
+        group[i]->doSomething(); // tell the obj to do something
+
+        // if the player died or found every barrel, end the level immediately
+        int status = checkLevelEnd();
+        if (status != GWSTATUS_CONTINUE_GAME)
+            return status;
+    }
+
+    return GWSTATUS_CONTINUE_GAME;
+}
+
+// the sleeping objs sit in the wheel's slots, so the cost of a pass grows with the objs due and not the whole group
+template <class T>
+int StudentWorld::moveGroup(TimerWheel<T>& wheel)
+{
+    wheel.startPass();
+
+    for (T* item = wheel.nextDue(); item != NULL; item = wheel.nextDue()) {
+        item->doSomething(); // tell the obj to do something
+
+        // if the player died or found every barrel, end the level immediately, the pass does not count
+        int status = checkLevelEnd();
+        if (status != GWSTATUS_CONTINUE_GAME) {
+            wheel.endPass(false);
+            return status;
+        }
+    }
+
+    // every due obj has had this pass
+    wheel.endPass(true);
+
+    return GWSTATUS_CONTINUE_GAME;
+}
+
+// slides the objs that are still alive to the front of group, then trims the dead ones off the end
+template <class T>
+void StudentWorld::sweepGroup(std::vector<T*>& group, SpatialGrid<T>* grid, TimerWheel<T>* wheel)
+{
+    size_t kept = 0;
+
+    for (size_t i = 0; i < group.size(); i++) {
+        T* item = group[i];
+
+        // keep the obj if it is still in play
+        if (item->getStatus()) {
+            group[kept++] = item;
+            continue;
+        }
+
+        // else remove it from its grid and wheel and free it
+        if (grid != NULL)
+            grid->remove(item, item->getX(), item->getY());
+        if (wheel != NULL)
+            wheel->remove(item);
+        retire(item);
+    }
+
+    group.resize(kept);
+}
+
+// used when the level ends, so the grids are cleared separately
+template <class T>
+void StudentWorld::destroyGroup(std::vector<T*>& group)
+{
+    for (size_t i = 0; i < group.size(); i++)
+        retire(group[i]);
+
+    group.clear();
+}
+
 #endif // STUDENTWORLD_H_
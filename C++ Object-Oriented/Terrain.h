@@ -0,0 +1,285 @@
+#ifndef TERRAIN_H_
+#define TERRAIN_H_
+
+#include "GameConstants.h"
+#include "WorldSize.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// storage for a BasicTerrain whose size is fixed at compile time
+// the size and the number of words per row are constants, so every loop over them can be unrolled
+template <int W, int H>
+struct terrainStore {
+    static constexpr int width = W; // number of columns
+    static constexpr int height = H; // number of rows, including the top band
+    static constexpr int words = (W + 63) / 64; // number of words in each row
+
+    uint64_t earthRows[words * H]; // bit x of row y is set if (x, y) holds Earth
+    uint64_t boulderRows[words * H]; // bit x of row y is set if (x, y) holds part of a Boulder
+    uint64_t openRows[words * (H - SPRITE_HEIGHT + 1)]; // bit x of row y is set if a sprite at (x, y) overlaps nothing
+
+    // constructor, the size is already known
+    terrainStore(int, int) {}
+};
+
+// storage for a BasicTerrain whose size is chosen at run time, which StudentWorld has already checked
+template <>
+struct terrainStore<0, 0> {
+    int width; // number of columns
+    int height; // number of rows, including the top band
+    int words; // number of words in each row
+
+    std::vector<uint64_t> earthRows; // bit x of row y is set if (x, y) holds Earth
+    std::vector<uint64_t> boulderRows; // bit x of row y is set if (x, y) holds part of a Boulder
+    std::vector<uint64_t> openRows; // bit x of row y is set if a sprite at (x, y) overlaps nothing
+
+    // constructor, makes room for a widthIn by heightIn field
+    terrainStore(int widthIn, int heightIn)
+    {
+        width = widthIn;
+        height = heightIn;
+        words = (width + 63) / 64;
+
+        earthRows.assign(size_t(words) * height, 0);
+        boulderRows.assign(size_t(words) * height, 0);
+        openRows.assign(size_t(words) * (height - SPRITE_HEIGHT + 1), 0);
+    }
+};
+
+// bitboard layer for the Earth and Boulders in the oil field
+// every row is stored as one or more uint64_t words, where bit x % 64 of word x / 64 stands for column x
+// the field is W columns by H rows, and the top SPRITE_HEIGHT rows are the empty band at the top
+// of the screen that always stays clear. W and H of 0 mean the size is chosen when the terrain is built
+// the whole class lives in this header so the size can be folded into the callers
+template <int W, int H>
+class BasicTerrain {
+public:
+    // constructor, starts with an empty field, widthIn by heightIn if the size is not fixed
+    BasicTerrain(int widthIn = 64, int heightIn = 64);
+
+    // returns the size of the field, including the top band
+    int getWidth() const { return cells.width; }
+    int getHeight() const { return cells.height; }
+
+    // fills every cell below the top band with Earth and removes all Boulders
+    void fill();
+
+    // returns TID_EARTH, TID_BOULDER, or -1 for the in-bounds cell (x, y)
+    int cellID(int x, int y) const;
+
+    // sets the in-bounds cell (x, y) to hold TID_EARTH, TID_BOULDER, or nothing (-1)
+    void setCellID(int x, int y, int ID);
+
+    // removes the Earth from the cells (x, y) to (x + len - 1, y), where len is at most 64
+    // returns a mask where bit i is set if (x + i, y) held Earth before, so the caller can hide their sprites
+    uint64_t clearEarth(int x, int y, int len);
+
+    // returns true if a sprite at (x, y) overlaps Earth or Boulders
+    bool dirtHere(int x, int y) const;
+
+    // returns true if any cell in the w by h rectangle at (x, y) holds Earth or a Boulder
+    // cells outside of the field never count as dirt
+    bool dirtIn(int x, int y, int w, int h) const { return anyIn(true, true, x, y, w, h); }
+
+    // returns true if any cell from (x, y) to (x + len - 1, y) holds Earth or a Boulder
+    bool rowDirt(int x, int y, int len) const { return dirtIn(x, y, len, 1); }
+
+    // returns true if any cell from (x, y) to (x, y + len - 1) holds Earth or a Boulder
+    bool columnDirt(int x, int y, int len) const { return dirtIn(x, y, 1, len); }
+
+    // returns true if any cell in the w by h rectangle at (x, y) holds Earth
+    bool earthIn(int x, int y, int w, int h) const { return anyIn(true, false, x, y, w, h); }
+
+    // returns true if any cell in the w by h rectangle at (x, y) holds a Boulder
+    bool boulderIn(int x, int y, int w, int h) const { return anyIn(false, true, x, y, w, h); }
+
+private:
+    terrainStore<W, H> cells; // the size and the rows of bits
+
+    // returns the mask of the columns from lo to hi - 1 that fall in word w of a row
+    static uint64_t wordMask(int lo, int hi, int w);
+
+    // returns true if any cell in the w by h rectangle at (x, y) is set in earthRows (if earth is true)
+    // or boulderRows (if boulders is true)
+    bool anyIn(bool earth, bool boulders, int x, int y, int w, int h) const;
+
+    // recomputes openRows for every sprite row that covers rows y to y + h - 1
+    void updateOpenRows(int y, int h);
+};
+
+// the terrain the game is built with: the game's own 64 by 64 field, or any size under TUNNELMAN_DYNAMIC_SIZE
+typedef BasicTerrain<WORLD_WIDTH, WORLD_HEIGHT> Terrain;
+
+// constructor, starts with no Earth or Boulders anywhere
+template <int W, int H>
+BasicTerrain<W, H>::BasicTerrain(int widthIn, int heightIn)
+    : cells(widthIn, heightIn)
+{
+    for (size_t i = 0; i < size_t(cells.words) * cells.height; i++) {
+        cells.earthRows[i] = 0;
+        cells.boulderRows[i] = 0;
+    }
+
+    updateOpenRows(0, cells.height);
+}
+
+// fills the field with Earth, leaving the top band clear
+// only the columns inside the field are set, so the spare bits at the end of the last word stay clear
+template <int W, int H>
+void BasicTerrain<W, H>::fill()
+{
+    for (int y = 0; y < cells.height; y++)
+        for (int w = 0; w < cells.words; w++) {
+            cells.earthRows[size_t(y) * cells.words + w] = (y < cells.height - SPRITE_HEIGHT) ? wordMask(0, cells.width, w) : 0;
+            cells.boulderRows[size_t(y) * cells.words + w] = 0;
+        }
+
+    updateOpenRows(0, cells.height);
+}
+
+// returns the ID stored at (x, y)
+template <int W, int H>
+int BasicTerrain<W, H>::cellID(int x, int y) const
+{
+    size_t word = size_t(y) * cells.words + (x >> 6);
+
+    if ((cells.earthRows[word] >> (x & 63)) & 1)
+        return TID_EARTH;
+
+    if ((cells.boulderRows[word] >> (x & 63)) & 1)
+        return TID_BOULDER;
+
+    return -1;
+}
+
+// replaces whatever is at (x, y) with ID
+template <int W, int H>
+void BasicTerrain<W, H>::setCellID(int x, int y, int ID)
+{
+    size_t word = size_t(y) * cells.words + (x >> 6);
+    uint64_t bit = uint64_t(1) << (x & 63);
+
+    // clear the cell
+    cells.earthRows[word] &= ~bit;
+    cells.boulderRows[word] &= ~bit;
+
+    // then mark it with its new contents
+    if (ID == TID_EARTH)
+        cells.earthRows[word] |= bit;
+    else if (ID == TID_BOULDER)
+        cells.boulderRows[word] |= bit;
+
+    updateOpenRows(y, 1);
+}
+
+// clears the Earth in one row a word at a time, lining each word's dug bits up with x for the returned mask
+template <int W, int H>
+uint64_t BasicTerrain<W, H>::clearEarth(int x, int y, int len)
+{
+    if (y < 0 || y >= cells.height)
+        return 0;
+
+    int lo = (x > 0) ? x : 0;
+    int hi = (x + len < cells.width) ? x + len : cells.width;
+    if (lo >= hi)
+        return 0;
+
+    uint64_t dug = 0;
+
+    for (int w = lo >> 6; w <= (hi - 1) >> 6; w++) {
+        uint64_t& row = cells.earthRows[size_t(y) * cells.words + w];
+        uint64_t cleared = row & wordMask(lo, hi, w);
+        row &= ~cleared;
+
+        // bit b of this word is column 64 * w + b, which is bit 64 * w + b - x of the result
+        int shift = 64 * w - x;
+        if (shift >= 0)
+            dug |= cleared << shift;
+        else
+            dug |= cleared >> -shift;
+    }
+
+    // only touch the open rows if something was actually removed
+    if (dug != 0)
+        updateOpenRows(y, 1);
+
+    return dug;
+}
+
+// positions a sprite can stand on are a single bit test, anything else checks the 4x4 rectangle
+template <int W, int H>
+bool BasicTerrain<W, H>::dirtHere(int x, int y) const
+{
+    if (x >= 0 && x <= cells.width - SPRITE_WIDTH && y >= 0 && y <= cells.height - SPRITE_HEIGHT)
+        return !((cells.openRows[size_t(y) * cells.words + (x >> 6)] >> (x & 63)) & 1);
+
+    return dirtIn(x, y, SPRITE_WIDTH, SPRITE_HEIGHT);
+}
+
+// builds the mask for the part of columns lo to hi - 1 that lands in word w, which may be empty
+template <int W, int H>
+uint64_t BasicTerrain<W, H>::wordMask(int lo, int hi, int w)
+{
+    int first = (lo > 64 * w) ? lo - 64 * w : 0;
+    int last = (hi < 64 * w + 64) ? hi - 64 * w : 64;
+
+    if (first >= last)
+        return 0;
+
+    if (last - first == 64)
+        return ~uint64_t(0);
+
+    return ((uint64_t(1) << (last - first)) - 1) << first;
+}
+
+// tests each row of the rectangle against a mask of its columns, one word at a time
+// a rectangle in the game's own 64-wide field is only ever one word across
+template <int W, int H>
+bool BasicTerrain<W, H>::anyIn(bool earth, bool boulders, int x, int y, int w, int h) const
+{
+    // clip the rectangle to the field
+    int lo = (x > 0) ? x : 0;
+    int hi = (x + w < cells.width) ? x + w : cells.width;
+    if (lo >= hi)
+        return false;
+
+    int firstWord = lo >> 6;
+    int lastWord = (hi - 1) >> 6;
+
+    for (int j = (y > 0 ? y : 0); j < y + h && j < cells.height; j++)
+        for (int k = firstWord; k <= lastWord; k++) {
+            size_t word = size_t(j) * cells.words + k;
+            uint64_t taken = (earth ? cells.earthRows[word] : 0) | (boulders ? cells.boulderRows[word] : 0);
+
+            if (taken & wordMask(lo, hi, k))
+                return true;
+        }
+
+    return false;
+}
+
+// a sprite at row j covers rows j to j + 3, so changing rows y to y + h - 1 affects sprite rows y - 3 to y + h - 1
+template <int W, int H>
+void BasicTerrain<W, H>::updateOpenRows(int y, int h)
+{
+    for (int j = (y - 3 > 0 ? y - 3 : 0); j < y + h && j <= cells.height - SPRITE_HEIGHT; j++) {
+        for (int w = 0; w < cells.words; w++) {
+            // bit x of blocked is set if any of columns x to x + 3 hold Earth or Boulders in any of the four rows
+            // columns past the end of this word come from the low bits of the next one
+            uint64_t blocked = 0;
+            for (int k = j; k < j + SPRITE_HEIGHT; k++) {
+                size_t word = size_t(k) * cells.words + w;
+                uint64_t taken = cells.earthRows[word] | cells.boulderRows[word];
+                uint64_t next = (w + 1 < cells.words) ? cells.earthRows[word + 1] | cells.boulderRows[word + 1] : 0;
+
+                blocked |= taken | (taken >> 1 | next << 63) | (taken >> 2 | next << 62) | (taken >> 3 | next << 61);
+            }
+
+            // sprite positions 0 to width - SPRITE_WIDTH are the only ones a sprite can stand on
+            cells.openRows[size_t(j) * cells.words + w] = ~blocked & wordMask(0, cells.width - SPRITE_WIDTH + 1, w);
+        }
+    }
+}
+
+#endif // TERRAIN_H_
@@ -0,0 +1,19 @@
+#ifndef TERRAINLISTENER_H_
+#define TERRAINLISTENER_H_
+
+// anything that needs to know when the Earth or Boulders in part of the field change
+// a listener asks StudentWorld to watch a rectangle with watchTerrain, and is told about every change that touches it,
+// so it can skip checking the terrain on the ticks nothing near it has changed
+class TerrainListener {
+public:
+    // virtual destructor
+    virtual ~TerrainListener() {}
+
+    // called after cells in the w by h rectangle at (x, y) gained or lost Earth or Boulders
+    // the rectangle overlaps the watched one, but may be larger than it
+    // this can happen in the middle of another obj's turn, so listeners should only note the change here
+    // and act on it in their own doSomething
+    virtual void terrainChanged(int x, int y, int w, int h) = 0;
+};
+
+#endif // TERRAINLISTENER_H_
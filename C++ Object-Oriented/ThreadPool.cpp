@@ -0,0 +1,124 @@
+#include "ThreadPool.h"
+
+// constructor, each worker gets an empty queue before any thread starts
+ThreadPool::ThreadPool(int threads)
+    : queued(0), pending(0), nextQueue(0), stopping(false)
+{
+    if (threads < 1)
+        threads = 1;
+
+    for (int i = 0; i < threads; i++)
+        workers.push_back(new worker);
+
+    for (int i = 0; i < threads; i++)
+        this->threads.push_back(std::thread(&ThreadPool::run, this, i));
+}
+
+// destructor, lets the queued tasks finish before the threads are joined
+ThreadPool::~ThreadPool()
+{
+    wait();
+
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    for (size_t i = 0; i < workers.size(); i++)
+        delete workers[i];
+}
+
+// spreads tasks over the queues round robin, then wakes a sleeping worker
+void ThreadPool::submit(std::function<void()> task)
+{
+    worker* target = workers[nextQueue++ % workers.size()];
+
+    pending++;
+
+    {
+        std::lock_guard<std::mutex> guard(target->lock);
+        target->tasks.push_back(task);
+    }
+
+    // queued is raised under sleepLock so a worker cannot check it and then miss the wake up
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        queued++;
+    }
+    wake.notify_one();
+}
+
+// sleeps until the count of unfinished tasks reaches zero
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> guard(sleepLock);
+    idle.wait(guard, [this] { return pending == 0; });
+}
+
+// returns the number of workers
+int ThreadPool::size() const
+{
+    return int(threads.size());
+}
+
+// runs tasks while there are any, and sleeps on wake when every queue is empty
+void ThreadPool::run(int index)
+{
+    std::function<void()> task;
+
+    while (true) {
+        if (takeTask(index, task)) {
+            task();
+            task = nullptr; // free whatever the task held before sleeping
+
+            // if that was the last unfinished task, wake anyone waiting for the pool to go idle
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> guard(sleepLock);
+                idle.notify_all();
+            }
+
+            continue;
+        }
+
+        // every queue was empty, so sleep until a task is queued or the pool stops
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wake.wait(guard, [this] { return stopping || queued > 0; });
+
+        if (stopping && queued == 0)
+            return;
+    }
+}
+
+// the owner works from the back of its queue and thieves take from the front, so they rarely meet
+bool ThreadPool::takeTask(int index, std::function<void()>& task)
+{
+    // try the worker's own queue first
+    {
+        worker* own = workers[index];
+        std::lock_guard<std::mutex> guard(own->lock);
+        if (!own->tasks.empty()) {
+            task = own->tasks.back();
+            own->tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    // else try to steal from each of the other queues, starting with the next one over
+    for (size_t i = 1; i < workers.size(); i++) {
+        worker* victim = workers[(index + i) % workers.size()];
+        std::lock_guard<std::mutex> guard(victim->lock);
+        if (!victim->tasks.empty()) {
+            task = victim->tasks.front();
+            victim->tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
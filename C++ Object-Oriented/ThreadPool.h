@@ -0,0 +1,61 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// fixed set of worker threads that run submitted tasks
+// every worker has its own queue of tasks, and a worker whose queue runs dry steals from the front
+// of the others' queues, so long tasks on one thread do not leave the other threads idle
+class ThreadPool {
+public:
+    // constructor, starts threads workers (at least one)
+    ThreadPool(int threads);
+
+    // destructor, finishes every task that was submitted and then stops the workers
+    ~ThreadPool();
+
+    // queues task to be run on one of the workers
+    void submit(std::function<void()> task);
+
+    // blocks until every task submitted so far has finished
+    void wait();
+
+    // returns the number of worker threads
+    int size() const;
+
+private:
+    // struct for the queue of tasks owned by one worker
+    struct worker {
+        std::deque<std::function<void()> > tasks; // tasks waiting to run, newest at the back
+        std::mutex lock; // guards tasks
+    };
+
+    // copying a pool would copy running threads, so it is not allowed
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    std::vector<worker*> workers; // one queue per thread
+    std::vector<std::thread> threads; // the worker threads
+    std::mutex sleepLock; // guards stopping, and is held while waiting on wake or idle
+    std::condition_variable wake; // signalled when a task is queued or the pool is stopping
+    std::condition_variable idle; // signalled when the last running task finishes
+    std::atomic<long> queued; // number of tasks sitting in some queue
+    std::atomic<long> pending; // number of tasks queued or running
+    std::atomic<unsigned> nextQueue; // queue the next submitted task goes to, handed out round robin
+    bool stopping; // true once the destructor has asked the workers to stop
+
+    // loop run by the worker at index until the pool stops
+    void run(int index);
+
+    // takes the newest task from worker index's own queue, or else steals the oldest task from another queue
+    // returns false if every queue is empty
+    bool takeTask(int index, std::function<void()>& task);
+};
+
+#endif // THREADPOOL_H_
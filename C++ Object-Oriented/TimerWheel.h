@@ -0,0 +1,318 @@
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+#include <vector>
+#include <algorithm>
+#include <limits.h>
+#include <stddef.h>
+
+// struct every obj carries for the TimerWheel its kind is scheduled on, unused by kinds that are not
+struct wheelLink {
+    // values of list other than a slot number
+    enum { NONE = -1, AWAKE = -2, PENDING = -3, WOKEN = -4 };
+
+    long order; // place of the obj in its group, handed out by the wheel in the order objs are added
+    long sleepPass; // pass the obj fell asleep on
+    long wakePass; // first pass the obj acts on again, LONG_MAX to sleep until woken, 0 once wake has caught it up
+    int list; // slot the obj is filed in, or which of the wheel's lists holds it, NONE if it is on no list
+    size_t index; // where the obj is in that slot or list
+};
+
+// hierarchical timer wheel deciding which objs of one kind act on each pass, where a pass is one turn of the kind
+// an obj is awake until it sleeps, when it is filed in the slot of the pass it wakes on and is not visited at
+// all until then. the NEAR_SLOTS passes after the current one have a slot each, later passes share a far slot
+// per NEAR_SLOTS passes, which is split into the near slots once its passes come within range
+// due objs act in the order they were added, which is the order StudentWorld keeps its groups in, so every pass
+// plays out exactly as walking the whole group and skipping the sleepers would
+// T is a kind of obj, anything with a getWheelLink
+template <class T>
+class TimerWheel {
+public:
+    // number of passes with a slot each, and number of far slots of NEAR_SLOTS passes each, both powers of two
+    static const int NEAR_SLOTS = 64;
+    static const int FAR_SLOTS = 64;
+
+    // constructor, starts at pass 0 with nothing on the wheel
+    TimerWheel()
+    {
+        pass = 0;
+        nextOrder = 0;
+        running = false;
+        cursor = 0;
+        pendingNext = 0;
+        cursorOrder = -1;
+        holes = 0;
+    }
+
+    // returns the number of passes that have finished
+    long getPass() const
+    {
+        return pass;
+    }
+
+    // adds item awake, after every obj already on the wheel
+    void add(T* item)
+    {
+        wheelLink& link = item->getWheelLink();
+
+        link.order = nextOrder++;
+        link.wakePass = 0;
+        link.list = wheelLink::AWAKE;
+        link.index = awake.size();
+        awake.push_back(item);
+    }
+
+    // takes item off the wheel, wherever it is, so a later wake finds nothing to do
+    void remove(T* item)
+    {
+        unlink(item);
+        item->getWheelLink().wakePass = 0;
+    }
+
+    // takes every obj off the wheel, the passes keep counting from where they were
+    void clear()
+    {
+        awake.clear();
+        pending.clear();
+        woken.clear();
+        for (int i = 0; i < NEAR_SLOTS + FAR_SLOTS; i++)
+            slots[i].clear();
+
+        running = false;
+        holes = 0;
+    }
+
+    // called during item's own turn, files it under the pass it wakes on so it skips the next passes passes
+    // passes of LONG_MAX sleeps until wake is called
+    void sleepFor(T* item, long passes)
+    {
+        if (passes <= 0)
+            return;
+
+        wheelLink& link = item->getWheelLink();
+        unlink(item);
+
+        link.sleepPass = pass;
+        link.wakePass = (passes >= LONG_MAX - pass - 1) ? LONG_MAX : pass + 1 + passes;
+
+        // an obj sleeping until it is woken is not filed anywhere, since no pass will come for it
+        if (link.wakePass != LONG_MAX)
+            file(item);
+    }
+
+    // ends item's sleep, and returns the number of its turns it slept through
+    // item acts on its next turn, which is later in this pass if the pass is running and item's turn has not
+    // come yet, otherwise on the next pass
+    long wake(T* item)
+    {
+        wheelLink& link = item->getWheelLink();
+
+        // awake, or already caught up since it last slept
+        if (link.wakePass == 0)
+            return 0;
+
+        // the turns slept through are the ones after item fell asleep and before the next one it gets
+        bool missed = running && link.order < cursorOrder;
+        long next = missed ? pass + 1 : pass;
+        long skipped = ((next < link.wakePass) ? next : link.wakePass) - 1 - link.sleepPass;
+        link.wakePass = 0;
+
+        // an obj that is still filed, or sleeping until woken, moves to the objs due next
+        if (link.list >= 0 || link.list == wheelLink::NONE) {
+            unlink(item);
+
+            if (running && !missed)
+                insertPending(item);
+            else
+                append(woken, item, wheelLink::WOKEN);
+        }
+
+        return (skipped > 0) ? skipped : 0;
+    }
+
+    // starts the pass, bringing the objs that wake on it and the ones woken since the last pass into the awake list
+    void startPass()
+    {
+        // the far slot whose passes just came within range is split into the near slots first
+        if ((pass & (NEAR_SLOTS - 1)) == 0)
+            cascade();
+
+        // every obj filed under this pass is due from now on
+        std::vector<T*>& due = slots[pass & (NEAR_SLOTS - 1)];
+        for (size_t i = 0; i < due.size(); i++)
+            append(woken, due[i], wheelLink::WOKEN);
+        due.clear();
+
+        if (!woken.empty() || holes > 0)
+            mergeAwake();
+
+        running = true;
+        cursor = 0;
+        pendingNext = 0;
+        cursorOrder = -1;
+    }
+
+    // returns the obj whose turn is next this pass, or NULL once every due obj has had its turn
+    // objs woken during the pass are merged in by their order, so they act between the awake objs around them
+    T* nextDue()
+    {
+        // skip the holes left by objs that fell asleep during their turn
+        while (cursor < awake.size() && awake[cursor] == NULL)
+            cursor++;
+        while (pendingNext < pending.size() && pending[pendingNext] == NULL)
+            pendingNext++;
+
+        T* item = NULL;
+        bool fromPending = pendingNext < pending.size();
+        if (fromPending && cursor < awake.size())
+            fromPending = pending[pendingNext]->getWheelLink().order < awake[cursor]->getWheelLink().order;
+
+        if (fromPending)
+            item = pending[pendingNext++];
+        else if (cursor < awake.size())
+            item = awake[cursor++];
+
+        if (item != NULL)
+            cursorOrder = item->getWheelLink().order;
+
+        return item;
+    }
+
+    // ends the pass, which counts as finished unless the level ended partway through it
+    void endPass(bool finished)
+    {
+        // the objs woken during the pass stay awake, so they join the awake list when the next pass starts
+        for (size_t i = 0; i < pending.size(); i++)
+            if (pending[i] != NULL)
+                append(woken, pending[i], wheelLink::WOKEN);
+        pending.clear();
+
+        running = false;
+
+        if (finished)
+            pass++;
+    }
+
+private:
+    long pass; // number of passes finished, which is also the number of the current or next pass
+    long nextOrder; // order handed to the next obj added
+    bool running; // true between startPass and endPass
+    size_t cursor; // index in awake of the next obj to act this pass
+    size_t pendingNext; // index in pending of the next obj to act this pass
+    long cursorOrder; // order of the obj acting now, -1 before the first turn of the pass
+    size_t holes; // number of NULLs left in awake by objs that fell asleep or left the wheel
+
+    std::vector<T*> awake; // objs that act every pass, in order, with NULL holes until the next pass starts
+    std::vector<T*> pending; // objs woken during the pass whose turn in it has not come yet, in order
+    std::vector<T*> woken; // objs due from the next pass on that are not in awake yet, in no order
+    std::vector<T*> merged; // scratch space for mergeAwake, kept so passes never allocate
+    std::vector<T*> spill; // scratch space for cascade
+    std::vector<T*> slots[NEAR_SLOTS + FAR_SLOTS]; // sleeping objs, the near slots followed by the far slots
+
+    // adds item to the end of list, which is the list named by code
+    static void append(std::vector<T*>& list, T* item, int code)
+    {
+        wheelLink& link = item->getWheelLink();
+
+        link.list = code;
+        link.index = list.size();
+        list.push_back(item);
+    }
+
+    // removes the item at index from list, moving the last item into its place
+    static void swapOut(std::vector<T*>& list, size_t index)
+    {
+        list[index] = list.back();
+        list[index]->getWheelLink().index = index;
+        list.pop_back();
+    }
+
+    // takes item out of whichever slot or list holds it
+    // the ordered lists are walked during a pass, so item only leaves a hole in them
+    void unlink(T* item)
+    {
+        wheelLink& link = item->getWheelLink();
+
+        if (link.list == wheelLink::AWAKE) {
+            awake[link.index] = NULL;
+            holes++;
+        }
+        else if (link.list == wheelLink::PENDING)
+            pending[link.index] = NULL;
+        else if (link.list == wheelLink::WOKEN)
+            swapOut(woken, link.index);
+        else if (link.list >= 0)
+            swapOut(slots[link.list], link.index);
+
+        link.list = wheelLink::NONE;
+    }
+
+    // files a sleeping item in the slot for its wake pass, which is after the current pass
+    void file(T* item)
+    {
+        long wakePass = item->getWheelLink().wakePass;
+
+        int slot;
+        if (wakePass - pass < NEAR_SLOTS)
+            slot = int(wakePass & (NEAR_SLOTS - 1));
+        else
+            slot = NEAR_SLOTS + int((wakePass / NEAR_SLOTS) & (FAR_SLOTS - 1));
+
+        append(slots[slot], item, slot);
+    }
+
+    // refiles the far slot covering the NEAR_SLOTS passes from this one
+    // objs more than a full turn of the far slots away are filed back into the same slot, to wait for its next turn
+    void cascade()
+    {
+        // the slot is emptied before anything is filed, and the two vectors swap storage so neither allocates again
+        spill.clear();
+        spill.swap(slots[NEAR_SLOTS + int((pass / NEAR_SLOTS) & (FAR_SLOTS - 1))]);
+
+        for (size_t i = 0; i < spill.size(); i++)
+            file(spill[i]);
+
+        spill.clear();
+    }
+
+    // puts item into pending by its order, after every pending obj that has already acted
+    void insertPending(T* item)
+    {
+        long order = item->getWheelLink().order;
+
+        size_t at = pending.size();
+        while (at > pendingNext && pending[at - 1]->getWheelLink().order > order)
+            at--;
+
+        pending.insert(pending.begin() + at, item);
+        for (size_t i = at; i < pending.size(); i++) {
+            pending[i]->getWheelLink().list = wheelLink::PENDING;
+            pending[i]->getWheelLink().index = i;
+        }
+    }
+
+    // sorts the objs in woken into awake by their order, closing the holes on the way
+    void mergeAwake()
+    {
+        std::sort(woken.begin(), woken.end(), [](T* a, T* b) { return a->getWheelLink().order < b->getWheelLink().order; });
+
+        merged.clear();
+        size_t w = 0;
+        for (size_t i = 0; i < awake.size(); i++) {
+            if (awake[i] == NULL)
+                continue;
+
+            while (w < woken.size() && woken[w]->getWheelLink().order < awake[i]->getWheelLink().order)
+                append(merged, woken[w++], wheelLink::AWAKE);
+            append(merged, awake[i], wheelLink::AWAKE);
+        }
+        while (w < woken.size())
+            append(merged, woken[w++], wheelLink::AWAKE);
+
+        awake.swap(merged);
+        woken.clear();
+        holes = 0;
+    }
+};
+
+#endif // TIMERWHEEL_H_
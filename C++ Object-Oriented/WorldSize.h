@@ -0,0 +1,100 @@
+#ifndef WORLDSIZE_H_
+#define WORLDSIZE_H_
+
+#include "GameConstants.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// the size of the field, fixed at compile time unless TUNNELMAN_DYNAMIC_SIZE is defined
+// the normal build is specialized for the game's own 64 by 64 field, so every bounds check and per-row loop
+// in the terrain and the distance fields folds down to constants. defining TUNNELMAN_DYNAMIC_SIZE builds the
+// same code with the size read at run time instead, for stress runs on larger fields
+// a size of 0 stands for "chosen at run time" in every template below
+#ifdef TUNNELMAN_DYNAMIC_SIZE
+const int WORLD_WIDTH = 0;
+const int WORLD_HEIGHT = 0;
+#else
+const int WORLD_WIDTH = 64;
+const int WORLD_HEIGHT = 64;
+#endif
+
+// the range of sizes a field chosen at run time can have
+// boulders start between row 20 and 9 rows below the top of the field, which needs 29 rows, and at least one
+// column clear of the center shaft on the left, which needs 16 columns. the largest size keeps the two
+// distance fields of a world within a few hundred MB
+const int MIN_WORLD_WIDTH = 16;
+const int MIN_WORLD_HEIGHT = 29;
+const int MAX_WORLD_SIZE = 4096;
+
+// returns true if this build can make a width by height field
+// a fixed build only makes its own size
+inline bool worldSizeSupported(int width, int height)
+{
+    if (WORLD_WIDTH != 0)
+        return width == WORLD_WIDTH && height == WORLD_HEIGHT;
+
+    return width >= MIN_WORLD_WIDTH && width <= MAX_WORLD_SIZE && height >= MIN_WORLD_HEIGHT && height <= MAX_WORLD_SIZE;
+}
+
+// one entry of a distance field, the number of steps from a position to the field's source or -1
+// a shortest path never visits a position twice, so no distance is larger than the number of positions. that is
+// 61 * 61 in the game's own field, so 16 bits are enough and every field is half the size it would be with int
+#ifdef TUNNELMAN_DYNAMIC_SIZE
+typedef int32_t FieldDist;
+#else
+typedef int16_t FieldDist;
+static_assert((WORLD_WIDTH - SPRITE_WIDTH + 1) * (WORLD_HEIGHT - SPRITE_HEIGHT + 1) <= INT16_MAX, "distances must fit in FieldDist");
+#endif
+
+// one T for every position a sprite can stand at on a W by H field, indexed by (x, y)
+// held in a plain array when the size is fixed, so it needs no allocation and its index math is constant
+template <class T, int W, int H>
+class PositionGrid {
+public:
+    // the size is fixed, so there is nothing to do
+    void resize(int, int) {}
+
+    // returns the value for the position (x, y)
+    T& at(int x, int y) { return cells[x * ROWS + y]; }
+
+    // sets every position to value
+    void fill(T value)
+    {
+        for (int i = 0; i < COLUMNS * ROWS; i++)
+            cells[i] = value;
+    }
+
+private:
+    static const int COLUMNS = W - SPRITE_WIDTH + 1; // number of positions across the field
+    static const int ROWS = H - SPRITE_HEIGHT + 1; // number of positions up the field
+
+    T cells[COLUMNS * ROWS]; // the value for each position, column by column
+};
+
+// PositionGrid for a field whose size is chosen at run time
+template <class T>
+class PositionGrid<T, 0, 0> {
+public:
+    // constructor, holds nothing until resize is called
+    PositionGrid() { rows = 0; }
+
+    // makes room for every position on a width by height field
+    void resize(int width, int height)
+    {
+        rows = height - SPRITE_HEIGHT + 1;
+        cells.assign(size_t(width - SPRITE_WIDTH + 1) * rows, T());
+    }
+
+    // returns the value for the position (x, y)
+    T& at(int x, int y) { return cells[size_t(x) * rows + y]; }
+
+    // sets every position to value
+    void fill(T value) { cells.assign(cells.size(), value); }
+
+private:
+    int rows; // number of positions up the field
+    std::vector<T> cells; // the value for each position, column by column
+};
+
+#endif // WORLDSIZE_H_
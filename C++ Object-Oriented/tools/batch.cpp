@@ -0,0 +1,58 @@
+// plays many headless games at once and prints how each one went
+// usage: batch [sessions] [threads] [maxTicks] [maxLevel] [firstSeed] [idle|random] [width] [height]
+// built from this file plus every .cpp in the parent directory except GlutWorld.cpp, with -pthread
+
+#include "../BatchRunner.h"
+#include "../WorldSize.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+int main(int argc, char* argv[])
+{
+    // read the options, falling back to defaults for any that are missing
+    int sessions = (argc > 1) ? atoi(argv[1]) : 64;
+    int threads = (argc > 2) ? atoi(argv[2]) : int(std::thread::hardware_concurrency());
+    long maxTicks = (argc > 3) ? atol(argv[3]) : 20000;
+    unsigned int maxLevel = (argc > 4) ? unsigned(atoi(argv[4])) : 100;
+    uint64_t firstSeed = (argc > 5) ? strtoull(argv[5], NULL, 10) : 1;
+    InputPolicy::Kind input = (argc > 6 && strcmp(argv[6], "idle") == 0) ? InputPolicy::IDLE : InputPolicy::RANDOM;
+    int width = (argc > 7) ? atoi(argv[7]) : 64;
+    int height = (argc > 8) ? atoi(argv[8]) : width;
+
+    // a build with a fixed size can only play that size
+    if (WORLD_WIDTH != 0 && (width != WORLD_WIDTH || height != WORLD_HEIGHT)) {
+        fprintf(stderr, "this build only plays %dx%d fields, rebuild with -DTUNNELMAN_DYNAMIC_SIZE for others\n", WORLD_WIDTH, WORLD_HEIGHT);
+        return 2;
+    }
+
+    // a size outside the supported range would leave init no room for the level's objects
+    if (!worldSizeSupported(width, height)) {
+        fprintf(stderr, "fields must be from %dx%d up to %dx%d\n", MIN_WORLD_WIDTH, MIN_WORLD_HEIGHT, MAX_WORLD_SIZE, MAX_WORLD_SIZE);
+        return 2;
+    }
+
+    // one game per seed, starting from firstSeed
+    std::vector<sessionConfig> configs;
+    for (int i = 0; i < sessions; i++) {
+        sessionConfig config;
+        config.seed = firstSeed + i;
+        config.input = input;
+        config.maxTicks = maxTicks;
+        config.maxLevel = maxLevel;
+        config.lives = 3;
+        config.width = width;
+        config.height = height;
+        configs.push_back(config);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<sessionReport> reports = runBatch(configs, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printBatchReport(reports, seconds, stdout);
+
+    return 0;
+}
@@ -0,0 +1,254 @@
+// times the hot paths of the simulation on fixed-seed fixture worlds
+// usage: bench [secondsPerMeasurement] [seed] [size]
+// built from this file plus every .cpp in the parent directory except GlutWorld.cpp, with -pthread
+//
+// fixtures cover levels 0, 10, and 20, with 0, 5, and 15 protesters, on sparse (freshly dealt) and dug terrain
+// every fixture is size by size, 64 (the game's own field) unless another size is given
+// every measurement is printed as one line: fixture, what was timed, ns per call, and calls (or ticks) per second
+
+#include "../StudentWorld.h"
+#include "../InputPolicy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+
+// frontend for the fixtures: fixed level, plenty of lives, and keys from an InputPolicy
+class BenchFrontend : public GameFrontend {
+public:
+    // constructor, plays at level with keys from input
+    BenchFrontend(unsigned int level, InputPolicy* input)
+    {
+        this->level = level;
+        this->input = input;
+        lives = 1000000;
+        score = 0;
+    }
+
+    // asks the policy for this tick's key
+    virtual bool getKey(int& value) { return input->nextKey(value); }
+
+    // nothing is played, shown, or drawn
+    virtual void playSound(int) {}
+    virtual void setGameStatText(std::string) {}
+    virtual void objAdded(obj*) {}
+    virtual void objRemoved(obj*) {}
+    virtual void earthRemoved(int, int) {}
+
+    // level, lives, and score
+    virtual unsigned int getLevel() const { return level; }
+    virtual unsigned int getLives() const { return lives; }
+    virtual void decLives() { lives--; }
+    virtual unsigned int getScore() const { return score; }
+    virtual void increaseScore(unsigned int howMuch) { score += howMuch; }
+
+private:
+    unsigned int level; // level the fixture plays at
+    unsigned int lives; // lives left
+    unsigned int score; // game's score
+    InputPolicy* input; // where the keys come from
+};
+
+// a world set up for one combination of level, protesters, and terrain
+// only uses StudentWorld's public interface, including the hooks it has for benchmarks
+struct BenchmarkFixture {
+    unsigned int level; // level the world is playing
+    int protesters; // number of protesters placed
+    bool dug; // true if tunnels are dug through most of the field
+    uint64_t seed; // seed for the world, the input, and the placements
+    int size; // width and height of the field
+    RandomInput input; // keys for the full tick measurement
+    BenchFrontend frontend; // frontend the world runs against
+    StudentWorld world; // the fixture world
+    Random rng; // generator for picking positions
+
+    // constructor, builds the fixture world
+    BenchmarkFixture(unsigned int levelIn, int protestersIn, bool dugIn, uint64_t seedIn, int sizeIn)
+        : level(levelIn), protesters(protestersIn), dug(dugIn), seed(seedIn), size(sizeIn), input(seedIn),
+          frontend(levelIn, &input), world(&frontend, seedIn, sizeIn, sizeIn), rng(seedIn + 1)
+    {
+        build();
+    }
+
+    // destructor
+    ~BenchmarkFixture()
+    {
+        world.cleanUp();
+    }
+
+    // deals the level, digs the tunnels if asked, then places the protesters on open ground
+    void build()
+    {
+        world.init();
+
+        // keep the regular spawner from adding protesters so the count stays fixed
+        world.holdProtesterSpawns();
+
+        // dig a tunnel across every other band of four rows, joined by shafts down both sides
+        if (dug) {
+            for (int y = 0; y < world.getMaxY(); y += 8)
+                world.digEarth(0, y, world.getWidth(), 4);
+            world.digEarth(0, 0, 4, world.getMaxY());
+            world.digEarth(world.getMaxX(), 0, 4, world.getMaxY());
+        }
+
+        for (int i = 0; i < protesters; i++) {
+            ProtesterTemplate* p;
+            if (i % 2 == 0)
+                p = new HardProtester(&world);
+            else
+                p = new RegularProtester(&world);
+            world.addProtester(p);
+
+            // move the protester to a random open spot
+            int x, y;
+            do {
+                x = rng.bounded(0, world.getMaxX());
+                y = rng.bounded(0, world.getMaxY());
+            } while (world.dirtHere(x, y));
+            p->moveTo(x, y);
+        }
+    }
+
+    // starts the fixture over, used when a level ends during the full tick measurement
+    void rebuild()
+    {
+        world.cleanUp();
+        build();
+    }
+
+    // times every hot path on the fixture, printing one line per measurement
+    void bench(double seconds);
+
+    // returns a label such as "L10 P5 dug", with the size added if it is not the game's own
+    std::string name() const
+    {
+        std::string label = "L" + std::to_string(level) + " P" + std::to_string(protesters) + (dug ? " dug" : " sparse");
+        if (size != 64)
+            label += " " + std::to_string(size);
+        return label;
+    }
+};
+
+// runs op in growing batches until at least seconds have passed, and returns the nanoseconds per call
+template <class Op>
+double timeOp(double seconds, Op op)
+{
+    long calls = 0;
+    long batch = 1;
+    double elapsed = 0;
+
+    while (elapsed < seconds) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (long i = 0; i < batch; i++)
+            op(i);
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        calls += batch;
+        batch *= 2;
+    }
+
+    return elapsed * 1e9 / calls;
+}
+
+// prints one measurement
+void report(const BenchmarkFixture& fixture, const char* what, double nsPerOp)
+{
+    printf("%-16s %-24s %12.1f ns/op %14.0f op/s\n", fixture.name().c_str(), what, nsPerOp, 1e9 / nsPerOp);
+}
+
+// times every hot path on this fixture
+void BenchmarkFixture::bench(double seconds)
+{
+    StudentWorld& w = world;
+    volatile long sink = 0; // keeps results alive so the calls are not optimized away
+    int cols = w.getMaxX() + 1; // number of positions a sprite can stand at across the field
+    int rows = w.getMaxY() + 1; // number of positions a sprite can stand at up the field
+
+    // dirtHere over every position a sprite can stand on
+    report(*this, "dirtHere", timeOp(seconds, [&](long i) {
+        sink = sink + w.dirtHere(int(i % cols), int((i / cols) % rows));
+    }));
+
+    // distributionCollision over every position a sprite can stand on
+    report(*this, "distributionCollision", timeOp(seconds, [&](long i) {
+        sink = sink + w.distributionCollision(int(i % cols), int((i / cols) % rows));
+    }));
+
+    // a full BFS from the exit, which replaced the per-protester makePathTo searches
+    report(*this, "makeDistField(exit)", timeOp(seconds, [&](long) {
+        w.rebuildExitField();
+        sink = sink + w.getExitStep(0, 0).first;
+    }));
+
+    // a step towards the exit once the field is built
+    report(*this, "getExitStep", timeOp(seconds, [&](long i) {
+        sink = sink + w.getExitStep(int(i % cols), int((i / cols) % rows)).first;
+    }));
+
+    // the player field, rebuilt on every call as it is on the first hardcore query after the player steps
+    // queried at the player itself, since a query from outside the chase range never builds the field
+    report(*this, "getPlayerDist(rebuild)", timeOp(seconds, [&](long) {
+        w.rebuildPlayerField();
+        sink = sink + w.getPlayerDist(w.getPlayer()->getX(), w.getPlayer()->getY());
+    }));
+
+    // queries from every position, most of which are ruled out by their Manhattan distance to the player
+    report(*this, "getPlayerDist(any)", timeOp(seconds, [&](long i) {
+        sink = sink + w.getPlayerDist(int(i % cols), int((i / cols) % rows));
+    }));
+
+    // the player walking back and forth, digging through whatever is beside it
+    TunnelMan* player = w.getPlayer();
+    report(*this, "moveDir", timeOp(seconds, [&](long i) {
+        player->moveDir((i / 8) % 2 ? KEY_PRESS_LEFT : KEY_PRESS_RIGHT, true);
+    }));
+
+    // the same walk with the player field brought up to date after every step, which re-roots it instead of rebuilding it
+    // the difference from moveDir is what a step costs the hardcore protesters
+    report(*this, "getPlayerDist(step)", timeOp(seconds, [&](long i) {
+        player->moveDir((i / 8) % 2 ? KEY_PRESS_LEFT : KEY_PRESS_RIGHT, true);
+        sink = sink + w.getPlayerDist(player->getX(), player->getY());
+    }));
+
+    // the fixture is rebuilt so the full tick starts from the fixture, not from wherever moveDir left it
+    rebuild();
+
+    // full ticks, starting the fixture over whenever the level ends
+    double nsPerTick = timeOp(seconds, [&](long) {
+        if (w.move() != GWSTATUS_CONTINUE_GAME)
+            rebuild();
+    });
+    report(*this, "move (full tick)", nsPerTick);
+}
+
+int main(int argc, char* argv[])
+{
+    double seconds = (argc > 1) ? atof(argv[1]) : 0.2;
+    uint64_t seed = (argc > 2) ? strtoull(argv[2], NULL, 10) : 42;
+    int size = (argc > 3) ? atoi(argv[3]) : 64;
+
+    // a build with a fixed size can only bench that size
+    if (WORLD_WIDTH != 0 && (size != WORLD_WIDTH || size != WORLD_HEIGHT)) {
+        fprintf(stderr, "this build only plays %dx%d fields, rebuild with -DTUNNELMAN_DYNAMIC_SIZE for others\n", WORLD_WIDTH, WORLD_HEIGHT);
+        return 2;
+    }
+
+    // a size outside the supported range would leave init no room for the level's objects
+    if (!worldSizeSupported(size, size)) {
+        fprintf(stderr, "fields must be from %dx%d up to %dx%d\n", MIN_WORLD_WIDTH, MIN_WORLD_HEIGHT, MAX_WORLD_SIZE, MAX_WORLD_SIZE);
+        return 2;
+    }
+
+    const unsigned int levels[] = { 0, 10, 20 };
+    const int protesterCounts[] = { 0, 5, 15 };
+
+    for (int l = 0; l < 3; l++)
+        for (int p = 0; p < 3; p++)
+            for (int d = 0; d < 2; d++) {
+                BenchmarkFixture fixture(levels[l], protesterCounts[p], d == 1, seed, size);
+                fixture.bench(seconds);
+            }
+
+    return 0;
+}
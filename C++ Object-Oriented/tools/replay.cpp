@@ -0,0 +1,113 @@
+// records headless games to session logs and plays session logs back
+// usage: replay play <log> [repeats]
+//        replay record <log> [seed] [ticks] [idle|random] [width] [height]
+// built from this file plus every .cpp in the parent directory except GlutWorld.cpp, with -pthread
+//
+// play runs the logged game as fast as it will go, repeats times, and prints how long each run took
+// it exits with 1 if any run ends with a different score or top-of-screen text than the log
+// record plays a new game with an InputPolicy pressing the keys and saves it, e.g. to make fixed test cases
+// logs of games played with GLUT are made by setting TUNNELMAN_RECORD to a file before starting the game
+
+#include "../Replay.h"
+#include "../HeadlessGame.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// plays the game in path repeats times
+int play(const char* path, int repeats)
+{
+    SessionLog log;
+    if (!log.load(path)) {
+        fprintf(stderr, "could not read a session log from %s\n", path);
+        return 1;
+    }
+
+    // a build with a fixed size can only replay games played on that size
+    if (WORLD_WIDTH != 0 && (log.getWidth() != WORLD_WIDTH || log.getHeight() != WORLD_HEIGHT)) {
+        fprintf(stderr, "this build only plays %dx%d fields, rebuild with -DTUNNELMAN_DYNAMIC_SIZE to replay a %dx%d game\n",
+            WORLD_WIDTH, WORLD_HEIGHT, log.getWidth(), log.getHeight());
+        return 2;
+    }
+
+    printf("seed %llu, %u lives, %dx%d field, %ld ticks, %zu keys, score %u\n", (unsigned long long)log.getSeed(),
+        log.getStartLives(), log.getWidth(), log.getHeight(), log.getTicks(), log.getKeyCount(), log.getScore());
+
+    bool allMatch = true;
+    for (int i = 0; i < repeats; i++) {
+        replayReport report = replaySession(log);
+
+        printf("run %d: score %u, lives %u, level %u, %.3f s (%.0f ticks/s)%s\n", i, report.session.score,
+            report.session.lives, report.session.level, report.session.seconds,
+            report.session.seconds > 0 ? report.session.ticks / report.session.seconds : 0.0,
+            report.matches ? "" : "  MISMATCH");
+
+        if (!report.matches) {
+            printf("  expected: %s\n  got:      %s\n", log.getStatText().c_str(), report.statText.c_str());
+            allMatch = false;
+        }
+    }
+
+    return allMatch ? 0 : 1;
+}
+
+// plays a new game and saves it to path
+int record(const char* path, uint64_t seed, long maxTicks, InputPolicy::Kind kind, int width, int height)
+{
+    // a build with a fixed size can only play that size
+    if (WORLD_WIDTH != 0 && (width != WORLD_WIDTH || height != WORLD_HEIGHT)) {
+        fprintf(stderr, "this build only plays %dx%d fields, rebuild with -DTUNNELMAN_DYNAMIC_SIZE for others\n", WORLD_WIDTH, WORLD_HEIGHT);
+        return 2;
+    }
+
+    // a size outside the supported range would leave init no room for the level's objects
+    if (!worldSizeSupported(width, height)) {
+        fprintf(stderr, "fields must be from %dx%d up to %dx%d\n", MIN_WORLD_WIDTH, MIN_WORLD_HEIGHT, MAX_WORLD_SIZE, MAX_WORLD_SIZE);
+        return 2;
+    }
+
+    SessionLog log(seed, 3, width, height);
+    HeadlessGame game(seed, 3, width, height);
+    InputPolicy* input = makeInputPolicy(kind, seed);
+
+    game.setRecorder(&log);
+
+    long ticks = 0;
+    while (ticks < maxTicks && !game.isGameOver()) {
+        int key;
+        if (input->nextKey(key))
+            game.pushKey(key);
+
+        game.tick();
+        ticks++;
+    }
+
+    delete input;
+
+    if (!log.save(path)) {
+        fprintf(stderr, "could not write %s\n", path);
+        return 1;
+    }
+
+    printf("recorded %ld ticks, %zu keys, score %u to %s\n", log.getTicks(), log.getKeyCount(), log.getScore(), path);
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc >= 3 && strcmp(argv[1], "play") == 0)
+        return play(argv[2], (argc > 3) ? atoi(argv[3]) : 1);
+
+    if (argc >= 3 && strcmp(argv[1], "record") == 0) {
+        uint64_t seed = (argc > 3) ? strtoull(argv[3], NULL, 10) : 1;
+        long maxTicks = (argc > 4) ? atol(argv[4]) : 20000;
+        InputPolicy::Kind kind = (argc > 5 && strcmp(argv[5], "idle") == 0) ? InputPolicy::IDLE : InputPolicy::RANDOM;
+        int width = (argc > 6) ? atoi(argv[6]) : 64;
+        int height = (argc > 7) ? atoi(argv[7]) : width;
+        return record(argv[2], seed, maxTicks, kind, width, height);
+    }
+
+    fprintf(stderr, "usage: replay play <log> [repeats]\n       replay record <log> [seed] [ticks] [idle|random] [width] [height]\n");
+    return 2;
+}